@@ -35,6 +35,25 @@ public:
         }
     }
 
+    /// Replace the content with the given data. Already allocated device memory is reused if it is large enough,
+    /// such that repeated updates of the same size only copy the data
+    inline void update(int32_t dev, const T* ptr, size_t n)
+    {
+        if (dev != 0) {
+            if (n != 0) {
+                if (device != dev || static_cast<size_t>(device_mem.size()) < n)
+                    device_mem = std::move(anydsl::Array<T>(dev, reinterpret_cast<T*>(anydsl_alloc(dev, sizeof(T) * n)), n));
+                anydsl_copy(0, ptr, 0, dev, device_mem.data(), 0, sizeof(T) * n);
+            }
+            host_mem = nullptr;
+        } else {
+            host_mem = ptr;
+        }
+
+        device = dev;
+        size_  = n;
+    }
+
     inline ShallowArray(ShallowArray&&) = default;
     inline ShallowArray& operator=(ShallowArray&&) = default;
 
@@ -0,0 +1,10 @@
+#pragma once
+
+// Number of components of the streams shared between the driver and the artic code.
+// Expects the generated interface declaring RayStream, PrimaryStream and SecondaryStream to be included before.
+// TODO: This can be improved in the future with a c++ reflection system
+// We assume only pointers will be added to the structs, else the calculation has to be modified.
+constexpr size_t MaxRayPayloadComponents = sizeof(decltype(PrimaryStream::user)::e) / sizeof(decltype(PrimaryStream::user)::e[0]);
+constexpr size_t RayStreamSize           = sizeof(RayStream) / sizeof(RayStream::id);
+constexpr size_t PrimaryStreamSize       = RayStreamSize + MaxRayPayloadComponents + (sizeof(PrimaryStream) - sizeof(PrimaryStream::pad) - sizeof(PrimaryStream::size) - sizeof(PrimaryStream::rays) - sizeof(PrimaryStream::user)) / sizeof(PrimaryStream::ent_id);
+constexpr size_t SecondaryStreamSize     = RayStreamSize + (sizeof(SecondaryStream) - sizeof(SecondaryStream::pad) - sizeof(SecondaryStream::size) - sizeof(SecondaryStream::rays)) / sizeof(SecondaryStream::mat_id);
@@ -1,14 +1,19 @@
+#include "AdaptiveSampler.h"
 #include "Image.h"
 #include "Logger.h"
 #include "RuntimeStructs.h"
 #include "Statistics.h"
+#include "TileScheduler.h"
+#include "Timeline.h"
 #include "config/Version.h"
 #include "driver/Interface.h"
+#include "shader/ShaderCache.h"
 #include "table/SceneDatabase.h"
 
 #include "generated_interface.h"
 
 #include "ShallowArray.h"
+#include "StreamLayout.h"
 
 #include <anydsl_jit.h>
 #include <anydsl_runtime.hpp>
@@ -30,6 +35,28 @@
 #define DEVICE_GPU
 #endif
 
+#if defined(DEVICE_DEFAULT)
+constexpr IG::Target DriverTarget = IG::Target::GENERIC;
+#elif defined(DEVICE_SINGLE)
+constexpr IG::Target DriverTarget = IG::Target::SINGLE;
+#elif defined(DEVICE_AVX)
+constexpr IG::Target DriverTarget = IG::Target::AVX;
+#elif defined(DEVICE_AVX2)
+constexpr IG::Target DriverTarget = IG::Target::AVX2;
+#elif defined(DEVICE_AVX512)
+constexpr IG::Target DriverTarget = IG::Target::AVX512;
+#elif defined(DEVICE_SSE42)
+constexpr IG::Target DriverTarget = IG::Target::SSE42;
+#elif defined(DEVICE_ASIMD)
+constexpr IG::Target DriverTarget = IG::Target::ASIMD;
+#elif defined(DEVICE_NVVM)
+constexpr IG::Target DriverTarget = IG::Target::NVVM;
+#elif defined(DEVICE_AMD)
+constexpr IG::Target DriverTarget = IG::Target::AMDGPU;
+#else
+#error No device selected!
+#endif
+
 static inline size_t roundUp(size_t num, size_t multiple)
 {
     if (multiple == 0)
@@ -55,13 +82,6 @@ static Settings convert_settings(const DriverRenderSettings& settings, size_t it
     return renderSettings;
 }
 
-// TODO: This can be improved in the future with a c++ reflection system
-// We assume only pointers will be added to the struct below, else the calculation has to be modified.
-constexpr size_t MaxRayPayloadComponents = sizeof(decltype(PrimaryStream::user)::e) / sizeof(decltype(PrimaryStream::user)::e[0]);
-constexpr size_t RayStreamSize           = sizeof(RayStream) / sizeof(RayStream::id);
-constexpr size_t PrimaryStreamSize       = RayStreamSize + MaxRayPayloadComponents + (sizeof(PrimaryStream) - sizeof(PrimaryStream::pad) - sizeof(PrimaryStream::size) - sizeof(PrimaryStream::rays) - sizeof(PrimaryStream::user)) / sizeof(PrimaryStream::ent_id);
-constexpr size_t SecondaryStreamSize     = RayStreamSize + (sizeof(SecondaryStream) - sizeof(SecondaryStream::pad) - sizeof(SecondaryStream::size) - sizeof(SecondaryStream::rays)) / sizeof(SecondaryStream::mat_id);
-
 template <typename Node, typename Object>
 struct BvhProxy {
     ShallowArray<Node> Nodes;
@@ -106,13 +126,17 @@ struct ShaderStats {
 
 struct CPUData {
     anydsl::Array<float> cpu_primary;
+    anydsl::Array<float> cpu_primary_copy; // Only used if sorting out of place
     anydsl::Array<float> cpu_secondary;
     TemporaryStorageHostProxy temporary_storage_host;
     IG::Statistics stats;
+    IG::TimelineRecorder timeline;
     void* current_shader = nullptr;
     std::unordered_map<void*, ShaderStats> shader_stats;
 };
-thread_local CPUData* sThreadData = nullptr;
+thread_local CPUData* sThreadData  = nullptr;
+thread_local uint64_t sTileBeginNS = 0;     // Begin of the tile currently processed by the thread
+thread_local bool sTileMasked      = false; // True if some pixels of the tile currently processed by the thread converged
 
 constexpr size_t GPUStreamBufferCount = 2;
 class Interface {
@@ -139,7 +163,9 @@ public:
         std::array<anydsl::Array<float>, GPUStreamBufferCount> secondary;
         std::vector<anydsl::Array<float>> aovs;
         anydsl::Array<float> film_pixels;
-        anydsl::Array<StreamRay> ray_list;
+        ShallowArray<StreamRay> ray_list;
+        std::vector<StreamRay> ray_list_data; // Only used if the given rays have to be converted first
+        size_t ray_list_generation = 0;
         std::array<anydsl::Array<float>*, GPUStreamBufferCount> current_primary;
         std::array<anydsl::Array<float>*, GPUStreamBufferCount> current_secondary;
         std::unordered_map<std::string, DeviceImage> images;
@@ -174,6 +200,9 @@ public:
 #ifndef DEVICE_GPU
     tbb::concurrent_queue<CPUData*> available_thread_data;
 #endif
+    IG::TileScheduler tile_scheduler; // Only used by the CPU
+    // Only used by the CPU if adaptive sampling is enabled
+    std::unique_ptr<IG::AdaptiveSampler> adaptive_sampler;
     std::unordered_map<void*, ShaderInfo> shader_infos;
 
     std::vector<anydsl::Array<float>> aovs;
@@ -190,6 +219,9 @@ public:
     IG::TechniqueVariantShaderSet shader_set;
 
     IG::Statistics main_stats;
+    IG::Timeline main_timeline;
+    IG::ShaderCache shader_cache;
+    std::mutex jit_mutex;
 
     Settings driver_settings;
 
@@ -201,11 +233,16 @@ public:
         , current_iteration(0)
         , setup(setup)
         , main_stats()
+        , main_timeline()
+        , shader_cache(setup.shader_cache_dir ? std::filesystem::path(setup.shader_cache_dir) : std::filesystem::path(), DriverTarget, IG_VERSION_MAJOR, IG_VERSION_MINOR)
         , driver_settings()
     {
         // Due to the DLL interface, we do have multiple instances of the logger. Make sure they are the same
         IG_LOGGER = *setup.logger;
 
+        if (setup.adaptive_threshold > 0)
+            adaptive_sampler = std::make_unique<IG::AdaptiveSampler>(setup.adaptive_threshold, setup.adaptive_warmup);
+
         setupFramebuffer();
         setupThreadData();
     }
@@ -217,6 +254,9 @@ public:
         host_pixels = anydsl::Array<float>(film_width * film_height * 3);
         for (auto& arr : aovs)
             arr = anydsl::Array<float>(film_width * film_height * 3);
+
+        if (adaptive_sampler)
+            adaptive_sampler->resize(film_width, film_height);
     }
 
     inline void resizeFramebuffer(size_t width, size_t height)
@@ -259,6 +299,11 @@ public:
             available_thread_data.push(ptr);
         }
 #endif
+
+        if (setup.acquire_timeline) {
+            for (const auto& data : thread_data)
+                data->timeline.setCapacity(IG::TimelineRecorder::DefaultCapacity);
+        }
     }
 
     inline void setupShaderSet(const IG::TechniqueVariantShaderSet& shaderSet)
@@ -312,6 +357,24 @@ public:
         return sThreadData;
     }
 
+    inline void beginShaderLaunch(IG::ShaderType type, size_t workload, size_t id)
+    {
+        if (setup.acquire_stats)
+            getThreadData()->stats.beginShaderLaunch(type, workload, id);
+        if (setup.acquire_timeline)
+            getThreadData()->timeline.begin();
+    }
+
+    inline void endShaderLaunch(IG::ShaderType type, size_t id)
+    {
+        if (setup.acquire_timeline) {
+            const bool hasId = type == IG::ShaderType::Hit || type == IG::ShaderType::AdvancedShadowHit || type == IG::ShaderType::AdvancedShadowMiss || type == IG::ShaderType::Callback;
+            getThreadData()->timeline.end(IG::TimelineCategory::Shader, (uint32_t)type, hasId ? (int32_t)id : -1);
+        }
+        if (setup.acquire_stats)
+            getThreadData()->stats.endShaderLaunch(type, id);
+    }
+
     inline void setCurrentShader(int32_t dev, int workload, void* shader)
     {
 #ifdef DEVICE_GPU
@@ -349,6 +412,71 @@ public:
         return getThreadData()->cpu_primary;
     }
 
+    inline anydsl::Array<float>& getCPUSecondPrimaryStream(size_t size)
+    {
+        return resizeArray(0, getThreadData()->cpu_primary_copy, size, PrimaryStreamSize);
+    }
+
+    inline void swapCPUPrimaryStreams()
+    {
+        auto data = getThreadData();
+        std::swap(data->cpu_primary, data->cpu_primary_copy);
+    }
+
+    inline size_t prepareTiles(int32_t width, int32_t height, int32_t max_tile_size, int32_t num_cores)
+    {
+        // Zero cores means all available threads are used
+        const size_t thread_count = num_cores > 0 ? (size_t)num_cores : std::max<size_t>(1, std::thread::hardware_concurrency());
+        return tile_scheduler.prepare(width, height, max_tile_size, thread_count);
+    }
+
+    // Acquire and release are called by the same thread around the work of a single tile
+    inline int32_t acquireTile(IG::TileRegion& region)
+    {
+        uint32_t id = 0;
+        while (tile_scheduler.acquire(region, id)) {
+            // Tiles without any active pixel are skipped completely
+            if (adaptive_sampler && !adaptive_sampler->isActive(region))
+                continue;
+
+            // Only tiles with converged pixels have to check the mask for each sample
+            sTileMasked  = adaptive_sampler && !adaptive_sampler->isFullyActive(region);
+            sTileBeginNS = IG::TimelineRecorder::now();
+            return (int32_t)id;
+        }
+        return -1;
+    }
+
+    // Returns null if the current tile of the calling thread has no converged pixel
+    inline const uint8_t* getSampleMask() const
+    {
+        return adaptive_sampler && sTileMasked ? adaptive_sampler->mask() : nullptr;
+    }
+
+    // Called after each iteration, when the framebuffer contains the result of the iteration
+    inline void updateAdaptiveSampler()
+    {
+        if (!adaptive_sampler || current_settings.info.LockFramebuffer)
+            return;
+
+        IG_ASSERT(!aovs.empty(), "Expected the second moment to be the last AOV");
+        std::vector<float*> other_aovs;
+        for (size_t id = 0; id + 1 < aovs.size(); ++id)
+            other_aovs.push_back(aovs[id].data());
+
+        adaptive_sampler->update(host_pixels.data(), other_aovs, aovs.back().data(), current_iteration + 1);
+    }
+
+    inline size_t getActivePixelCount() const
+    {
+        return adaptive_sampler ? adaptive_sampler->activePixelCount() : film_width * film_height;
+    }
+
+    inline void releaseTile(int32_t id)
+    {
+        tile_scheduler.release((uint32_t)id, IG::TimelineRecorder::now() - sTileBeginNS);
+    }
+
     inline anydsl::Array<float>& getCPUSecondaryStream(size_t size)
     {
         return resizeArray(0, getThreadData()->cpu_secondary, size, SecondaryStreamSize);
@@ -434,18 +562,31 @@ public:
         return std::get<Bvh>(device.bvh_ent);
     }
 
-    inline const anydsl::Array<StreamRay>& loadRayList(int32_t dev)
+    inline const ShallowArray<StreamRay>& loadRayList(int32_t dev)
     {
+        static_assert(sizeof(StreamRay) == sizeof(IG::Ray), "Expected generated StreamRay and internal Ray to be of same size!");
+
+        // The number of rays is given by the work width, which might be smaller than the framebuffer (e.g., the last chunk of a stream)
+        const size_t count = current_settings.work_width;
+
         auto& device = devices[dev];
-        if (device.ray_list.size() == (int64_t)film_width)
+        if (device.ray_list_generation == current_settings.ray_generation && device.ray_list.size() == count)
             return device.ray_list;
 
         IG_ASSERT(current_settings.rays != nullptr, "Expected list of rays to be available");
 
-        std::vector<StreamRay> rays;
-        rays.reserve(film_width);
+        device.ray_list_generation = current_settings.ray_generation;
+
+        // Already normalized rays share the exact same layout and can be used as they are
+        if (current_settings.rays_normalized) {
+            device.ray_list.update(dev, reinterpret_cast<const StreamRay*>(current_settings.rays), count);
+            return device.ray_list;
+        }
+
+        auto& rays = device.ray_list_data;
+        rays.resize(count);
 
-        for (size_t i = 0; i < film_width; ++i) {
+        for (size_t i = 0; i < count; ++i) {
             const auto dRay = current_settings.rays[i];
 
             float norm = dRay.Direction.norm();
@@ -454,11 +595,10 @@ public:
                 norm = 1;
             }
 
-            // FIXME: Bytewise they are essentially the same...
-            StreamRay ray;
-            ray.org.x = dRay.Origin(0);
-            ray.org.y = dRay.Origin(1);
-            ray.org.z = dRay.Origin(2);
+            StreamRay& ray = rays[i];
+            ray.org.x      = dRay.Origin(0);
+            ray.org.y      = dRay.Origin(1);
+            ray.org.z      = dRay.Origin(2);
 
             ray.dir.x = dRay.Direction(0) / norm;
             ray.dir.y = dRay.Direction(1) / norm;
@@ -466,11 +606,10 @@ public:
 
             ray.tmin = dRay.Range(0);
             ray.tmax = dRay.Range(1);
-
-            rays.push_back(ray);
         }
 
-        return device.ray_list = copyToDevice(dev, rays);
+        device.ray_list.update(dev, rays.data(), rays.size());
+        return device.ray_list;
     }
 
     template <typename T>
@@ -524,10 +663,11 @@ public:
     {
         static_assert(sizeof(LookupEntry) == sizeof(IG::LookupEntry), "Expected generated Lookup Entry and internal Lookup Entry to be of same size!");
 
+        // On the host the memory of the table is used directly, which includes tables mapped from the scene cache
         DynTableProxy proxy;
         proxy.EntryCount    = tbl.entryCount();
-        proxy.LookupEntries = ShallowArray<LookupEntry>(dev, (LookupEntry*)tbl.lookups().data(), tbl.lookups().size());
-        proxy.Data          = ShallowArray<uint8_t>(dev, tbl.data().data(), tbl.data().size());
+        proxy.LookupEntries = ShallowArray<LookupEntry>(dev, (const LookupEntry*)tbl.lookupPtr(), tbl.entryCount());
+        proxy.Data          = ShallowArray<uint8_t>(dev, tbl.dataPtr(), tbl.dataSize());
         return proxy;
     }
 
@@ -555,6 +695,15 @@ public:
                           (int)database->MaterialCount };
     }
 
+    inline const int32_t* loadEntityMaterials(int32_t dev)
+    {
+        IG_ASSERT(dev == 0, "Expected the entity to material map only to be requested by the host");
+        IG_UNUSED(dev);
+
+        static_assert(sizeof(decltype(database->EntityToMaterial)::value_type) == sizeof(int32_t), "Expected material ids to be 32bit");
+        return reinterpret_cast<const int32_t*>(database->EntityToMaterial.data());
+    }
+
     inline const DynTableProxy& loadCustomDyntable(int32_t dev, const char* name)
     {
         auto& tables = devices[dev].custom_dyntables;
@@ -567,6 +716,13 @@ public:
         return tables[name] = loadDyntable(dev, database->CustomTables.at(name));
     }
 
+    // Drop device copies of the given table. The next access will load the (changed) table again
+    inline void updateCustomDyntable(const char* name)
+    {
+        for (auto& pair : devices)
+            pair.second.custom_dyntables.erase(name);
+    }
+
     inline const DeviceImage& loadImage(int32_t dev, const std::string& filename)
     {
         std::lock_guard<std::mutex> _guard(thread_mutex);
@@ -782,8 +938,7 @@ public:
 
     inline int runRayGenerationShader(int32_t dev, int* id, int size, int xmin, int ymin, int xmax, int ymax)
     {
-        if (setup.acquire_stats)
-            getThreadData()->stats.beginShaderLaunch(IG::ShaderType::RayGeneration, (xmax - xmin) * (ymax - ymin), {});
+        beginShaderLaunch(IG::ShaderType::RayGeneration, (xmax - xmin) * (ymax - ymin), {});
 
         using Callback = decltype(ig_ray_generation_shader);
         IG_ASSERT(shader_set.RayGenerationShader != nullptr, "Expected ray generation shader to be valid");
@@ -793,15 +948,13 @@ public:
 
         checkDebugOutput();
 
-        if (setup.acquire_stats)
-            getThreadData()->stats.endShaderLaunch(IG::ShaderType::RayGeneration, {});
+        endShaderLaunch(IG::ShaderType::RayGeneration, {});
         return ret;
     }
 
     inline void runMissShader(int32_t dev, int first, int last)
     {
-        if (setup.acquire_stats)
-            getThreadData()->stats.beginShaderLaunch(IG::ShaderType::Miss, last - first, {});
+        beginShaderLaunch(IG::ShaderType::Miss, last - first, {});
 
         using Callback = decltype(ig_miss_shader);
         IG_ASSERT(shader_set.MissShader != nullptr, "Expected miss shader to be valid");
@@ -811,16 +964,18 @@ public:
 
         checkDebugOutput();
 
-        if (setup.acquire_stats)
-            getThreadData()->stats.endShaderLaunch(IG::ShaderType::Miss, {});
+        endShaderLaunch(IG::ShaderType::Miss, {});
     }
 
     inline void runHitShader(int32_t dev, int entity_id, int first, int last)
     {
-        const int material_id = database->EntityToMaterial.at(entity_id);
+        runHitShader(dev, entity_id, database->EntityToMaterial.at(entity_id), first, last);
+    }
 
-        if (setup.acquire_stats)
-            getThreadData()->stats.beginShaderLaunch(IG::ShaderType::Hit, last - first, material_id);
+    // The entity id is -1 if the range is sorted by material and each ray carries its own entity
+    inline void runHitShader(int32_t dev, int entity_id, int material_id, int first, int last)
+    {
+        beginShaderLaunch(IG::ShaderType::Hit, last - first, material_id);
 
         using Callback = decltype(ig_hit_shader);
         IG_ASSERT(material_id >= 0 && material_id < (int)shader_set.HitShaders.size(), "Expected material id for hit shaders to be valid");
@@ -828,12 +983,11 @@ public:
         IG_ASSERT(hit_shader != nullptr, "Expected hit shader to be valid");
         auto callback = reinterpret_cast<Callback*>(hit_shader);
         setCurrentShader(dev, last - first, (void*)callback);
-        callback(&driver_settings, entity_id, first, last);
+        callback(&driver_settings, entity_id, material_id, first, last);
 
         checkDebugOutput();
 
-        if (setup.acquire_stats)
-            getThreadData()->stats.endShaderLaunch(IG::ShaderType::Hit, material_id);
+        endShaderLaunch(IG::ShaderType::Hit, material_id);
     }
 
     inline bool useAdvancedShadowHandling()
@@ -846,8 +1000,7 @@ public:
         IG_ASSERT(useAdvancedShadowHandling(), "Expected advanced shadow shader only be called if it is enabled!");
 
         if (is_hit) {
-            if (setup.acquire_stats)
-                getThreadData()->stats.beginShaderLaunch(IG::ShaderType::AdvancedShadowHit, last - first, material_id);
+            beginShaderLaunch(IG::ShaderType::AdvancedShadowHit, last - first, material_id);
 
             using Callback = decltype(ig_advanced_shadow_shader);
             IG_ASSERT(material_id >= 0 && material_id < (int)shader_set.AdvancedShadowHitShaders.size(), "Expected material id for advanced shadow hit shaders to be valid");
@@ -859,11 +1012,9 @@ public:
 
             checkDebugOutput();
 
-            if (setup.acquire_stats)
-                getThreadData()->stats.endShaderLaunch(IG::ShaderType::AdvancedShadowHit, material_id);
+            endShaderLaunch(IG::ShaderType::AdvancedShadowHit, material_id);
         } else {
-            if (setup.acquire_stats)
-                getThreadData()->stats.beginShaderLaunch(IG::ShaderType::AdvancedShadowMiss, last - first, material_id);
+            beginShaderLaunch(IG::ShaderType::AdvancedShadowMiss, last - first, material_id);
 
             using Callback = decltype(ig_advanced_shadow_shader);
             IG_ASSERT(material_id >= 0 && material_id < (int)shader_set.AdvancedShadowMissShaders.size(), "Expected material id for advanced shadow miss shaders to be valid");
@@ -875,8 +1026,7 @@ public:
 
             checkDebugOutput();
 
-            if (setup.acquire_stats)
-                getThreadData()->stats.endShaderLaunch(IG::ShaderType::AdvancedShadowMiss, material_id);
+            endShaderLaunch(IG::ShaderType::AdvancedShadowMiss, material_id);
         }
     }
 
@@ -885,8 +1035,7 @@ public:
         IG_ASSERT(type >= 0 && type < (int)IG::CallbackType::_COUNT, "Expected callback shader type to be well formed!");
 
         if (shader_set.CallbackShaders[type] != nullptr) {
-            if (setup.acquire_stats)
-                getThreadData()->stats.beginShaderLaunch(IG::ShaderType::Callback, 1, type);
+            beginShaderLaunch(IG::ShaderType::Callback, 1, type);
 
             using Callback = decltype(ig_callback_shader);
             auto callback  = reinterpret_cast<Callback*>(shader_set.CallbackShaders[type]);
@@ -895,8 +1044,7 @@ public:
 
             checkDebugOutput();
 
-            if (setup.acquire_stats)
-                getThreadData()->stats.endShaderLaunch(IG::ShaderType::Callback, type);
+            endShaderLaunch(IG::ShaderType::Callback, type);
         }
     }
 
@@ -985,6 +1133,13 @@ public:
     /// Clear specific aov or clear all if aov < 0. Note, aov == 0 is the framebuffer
     inline void clear(int aov)
     {
+        // The estimates and tile costs are bound to the content of the framebuffer, e.g., the current view
+        if (aov <= 0) {
+            tile_scheduler.reset();
+            if (adaptive_sampler)
+                adaptive_sampler->reset();
+        }
+
         if (aov <= 0) {
             std::memset(host_pixels.data(), 0, sizeof(float) * host_pixels.size());
             for (auto& pair : devices) {
@@ -1015,10 +1170,27 @@ public:
         for (const auto& data : thread_data)
             main_stats.add(data->stats);
 
+        main_stats.addShaderCacheMarkers(shader_cache.foundMarkerCount(), shader_cache.missingMarkerCount());
         return &main_stats;
     }
 
+    // Each lane corresponds to a slot of the thread data pool, not to a specific system thread
+    inline IG::Timeline* getFullTimeline()
+    {
+        main_timeline.clear();
+        for (const auto& data : thread_data)
+            data->timeline.snapshot(main_timeline.addLane());
+
+        return &main_timeline;
+    }
+
     // Access parameters
+    const float* getParameterBlock()
+    {
+        IG_ASSERT(current_parameters != nullptr, "No parameters available!");
+        return current_parameters->Block.data();
+    }
+
     int getParameterInt(const char* name, int def)
     {
         IG_ASSERT(current_parameters != nullptr, "No parameters available!");
@@ -1083,16 +1255,13 @@ void glue_render(const IG::TechniqueVariantShaderSet& shaderSet, const DriverRen
     sInterface->current_parameters = parameterSet;
     sInterface->driver_settings    = convert_settings(settings, iter, frame);
 
-    CPUData* cpu_data = nullptr;
-    if (sInterface->setup.acquire_stats) {
-        cpu_data = sInterface->getThreadData();
-        cpu_data->stats.beginShaderLaunch(IG::ShaderType::Device, 1, {});
-    }
+    sInterface->beginShaderLaunch(IG::ShaderType::Device, 1, {});
 
     ig_render(&sInterface->driver_settings);
 
-    if (sInterface->setup.acquire_stats)
-        cpu_data->stats.endShaderLaunch(IG::ShaderType::Device, {});
+    sInterface->endShaderLaunch(IG::ShaderType::Device, {});
+
+    sInterface->updateAdaptiveSampler();
 
     sInterface->unregisterThread();
 }
@@ -1104,6 +1273,18 @@ void glue_setup(const DriverSetupSettings& settings)
 
     // Make sure the functions exposed are available in the linking process
     anydsl_link(settings.driver_filename);
+
+#ifdef IG_WITH_PARALLEL_JIT
+    IG_LOG(IG::L_DEBUG) << "Shaders are compiled in parallel" << std::endl;
+#else
+    IG_LOG(IG::L_DEBUG) << "Calls into the AnyDSL jit are serialized, only shader preparation runs in parallel. Build with IG_WITH_PARALLEL_JIT if the AnyDSL runtime is reentrant" << std::endl;
+#endif
+
+    // Let the jit store and reload compiled modules in our target and version specific cache directory
+    if (sInterface->shader_cache.isEnabled()) {
+        IG_LOG(IG::L_DEBUG) << "Using shader cache " << sInterface->shader_cache.directory() << std::endl;
+        anydsl_set_cache_directory(sInterface->shader_cache.directory().generic_u8string().c_str());
+    }
 }
 
 void glue_shutdown()
@@ -1129,18 +1310,32 @@ void glue_clearFramebuffer(int aov)
     sInterface->clear(aov);
 }
 
+void glue_updateCustomDyntable(const char* name)
+{
+    sInterface->updateCustomDyntable(name);
+}
+
 const IG::Statistics* glue_getStatistics()
 {
     return sInterface->getFullStats();
 }
 
+const IG::Timeline* glue_getTimeline()
+{
+    return sInterface->getFullTimeline();
+}
+
+size_t glue_getActivePixelCount()
+{
+    return sInterface->getActivePixelCount();
+}
+
 void glue_tonemap(size_t device, uint32_t* out_pixels, const IG::TonemapSettings& driver_settings)
 {
     // Register host thread
     sInterface->registerThread();
 
-    if (sInterface->setup.acquire_stats)
-        sInterface->getThreadData()->stats.beginShaderLaunch(IG::ShaderType::Tonemap, 1, {});
+    sInterface->beginShaderLaunch(IG::ShaderType::Tonemap, 1, {});
 
 #ifdef DEVICE_GPU
 #if defined(DEVICE_NVVM)
@@ -1169,8 +1364,7 @@ void glue_tonemap(size_t device, uint32_t* out_pixels, const IG::TonemapSettings
     anydsl_copy(dev_id, device_out_pixels, 0, 0 /* Host */, out_pixels, 0, sizeof(uint32_t) * size);
 #endif
 
-    if (sInterface->setup.acquire_stats)
-        sInterface->getThreadData()->stats.endShaderLaunch(IG::ShaderType::Tonemap, {});
+    sInterface->endShaderLaunch(IG::ShaderType::Tonemap, {});
 
     sInterface->unregisterThread();
 }
@@ -1180,8 +1374,7 @@ void glue_imageinfo(size_t device, const IG::ImageInfoSettings& driver_settings,
     // Register host thread
     sInterface->registerThread();
 
-    if (sInterface->setup.acquire_stats)
-        sInterface->getThreadData()->stats.beginShaderLaunch(IG::ShaderType::ImageInfo, 1, {});
+    sInterface->beginShaderLaunch(IG::ShaderType::ImageInfo, 1, {});
 
 #ifdef DEVICE_GPU
 #if defined(DEVICE_NVVM)
@@ -1209,8 +1402,7 @@ void glue_imageinfo(size_t device, const IG::ImageInfoSettings& driver_settings,
     driver_output.SoftMax = output.soft_max;
     driver_output.Median  = output.median;
 
-    if (sInterface->setup.acquire_stats)
-        sInterface->getThreadData()->stats.endShaderLaunch(IG::ShaderType::ImageInfo, {});
+    sInterface->endShaderLaunch(IG::ShaderType::ImageInfo, {});
 
     sInterface->unregisterThread();
 }
@@ -1259,18 +1451,37 @@ constexpr uint32_t OPT_LEVEL = 3;
 
 void* glue_compileSource(const char* src, const char* function, bool isVerbose)
 {
+    const std::string_view source(src);
+    const IG::uint64 key = sInterface->shader_cache.computeKey(source);
+    const bool cached    = sInterface->shader_cache.has(key, source);
+    if (cached)
+        IG_LOG(IG::L_DEBUG) << "Found shader cache marker for " << function << std::endl;
+
+    void* func = nullptr;
+    {
+        // The AnyDSL jit keeps a global log level and an unsynchronized registry of compiled programs.
+        // Everything outside this block is safe to be called concurrently.
+#ifndef IG_WITH_PARALLEL_JIT
+        std::lock_guard<std::mutex> _guard(sInterface->jit_mutex);
+#endif
+
 #ifdef IG_DEBUG
-    anydsl_set_log_level(isVerbose ? 1 /* info */ : 4 /* error */);
+        anydsl_set_log_level(isVerbose ? 1 /* info */ : 4 /* error */);
 #else
-    anydsl_set_log_level(isVerbose ? 3 /* warn */ : 4 /* error */);
+        anydsl_set_log_level(isVerbose ? 3 /* warn */ : 4 /* error */);
 #endif
 
-    size_t len = std::strlen(src);
-    int ret    = anydsl_compile(src, (uint32_t)len, OPT_LEVEL);
-    if (ret < 0)
-        return nullptr;
+        int ret = anydsl_compile(src, (uint32_t)source.size(), OPT_LEVEL);
+        if (ret < 0)
+            return nullptr;
+
+        func = anydsl_lookup_function(ret, function);
+    }
+
+    if (!cached)
+        sInterface->shader_cache.store(key, source);
 
-    return anydsl_lookup_function(ret, function);
+    return func;
 }
 
 extern "C" {
@@ -1280,29 +1491,7 @@ IG_EXPORT DriverInterface ig_get_interface()
     };
     interface.MajorVersion = IG_VERSION_MAJOR;
     interface.MinorVersion = IG_VERSION_MINOR;
-
-// Expose Target
-#if defined(DEVICE_DEFAULT)
-    interface.Target = IG::Target::GENERIC;
-#elif defined(DEVICE_SINGLE)
-    interface.Target = IG::Target::SINGLE;
-#elif defined(DEVICE_AVX)
-    interface.Target = IG::Target::AVX;
-#elif defined(DEVICE_AVX2)
-    interface.Target = IG::Target::AVX2;
-#elif defined(DEVICE_AVX512)
-    interface.Target = IG::Target::AVX512;
-#elif defined(DEVICE_SSE42)
-    interface.Target = IG::Target::SSE42;
-#elif defined(DEVICE_ASIMD)
-    interface.Target = IG::Target::ASIMD;
-#elif defined(DEVICE_NVVM)
-    interface.Target = IG::Target::NVVM;
-#elif defined(DEVICE_AMD)
-    interface.Target = IG::Target::AMDGPU;
-#else
-#error No device selected!
-#endif
+    interface.Target       = DriverTarget;
 
     interface.SetupFunction             = glue_setup;
     interface.ShutdownFunction          = glue_shutdown;
@@ -1311,10 +1500,14 @@ IG_EXPORT DriverInterface ig_get_interface()
     interface.GetFramebufferFunction    = glue_getFramebuffer;
     interface.ClearFramebufferFunction  = glue_clearFramebuffer;
     interface.GetStatisticsFunction     = glue_getStatistics;
+    interface.GetTimelineFunction       = glue_getTimeline;
+    interface.ActivePixelCountFunction  = glue_getActivePixelCount;
     interface.TonemapFunction           = glue_tonemap;
     interface.ImageInfoFunction         = glue_imageinfo;
     interface.CompileSourceFunction     = glue_compileSource;
 
+    interface.UpdateCustomDyntableFunction = glue_updateCustomDyntable;
+
     return interface;
 }
 
@@ -1343,6 +1536,9 @@ IG_EXPORT void ignis_get_work_info(WorkInfo* info)
     info->advanced_shadows                = sInterface->useAdvancedShadowHandling() && sInterface->current_settings.info.ShadowHandlingMode == IG::ShadowHandlingMode::Advanced;
     info->advanced_shadows_with_materials = sInterface->useAdvancedShadowHandling() && sInterface->current_settings.info.ShadowHandlingMode == IG::ShadowHandlingMode::AdvancedWithMaterials;
     info->framebuffer_locked              = sInterface->current_settings.info.LockFramebuffer;
+    info->sort_primary_out_of_place       = sInterface->setup.sort_primary_out_of_place;
+    info->sort_primary_by_material        = sInterface->setup.sort_primary_by_material;
+    info->adaptive_sampling               = sInterface->adaptive_sampler != nullptr;
 }
 
 IG_EXPORT void ignis_load_bvh2_ent(int dev, Node2** nodes, EntityLeaf1** objs)
@@ -1389,6 +1585,11 @@ IG_EXPORT void ignis_load_scene_info(int dev, SceneInfo* info)
     *info = sInterface->loadSceneInfo(dev);
 }
 
+IG_EXPORT void ignis_load_entity_materials(int dev, int32_t** map)
+{
+    *map = const_cast<int32_t*>(sInterface->loadEntityMaterials(dev));
+}
+
 IG_EXPORT void ignis_load_custom_dyntable(int dev, const char* name, DynTable* dtb)
 {
     auto assign = [&](const DynTableProxy& tbl) {
@@ -1407,7 +1608,7 @@ IG_EXPORT void ignis_load_custom_dyntable(int dev, const char* name, DynTable* d
 
 IG_EXPORT void ignis_load_rays(int dev, StreamRay** list)
 {
-    *list = const_cast<StreamRay*>(sInterface->loadRayList(dev).data());
+    *list = const_cast<StreamRay*>(sInterface->loadRayList(dev).ptr());
 }
 
 IG_EXPORT void ignis_load_image(int32_t dev, const char* file, float** pixels, int32_t* width, int32_t* height)
@@ -1456,6 +1657,44 @@ IG_EXPORT void ignis_cpu_get_primary_stream_const(PrimaryStream* primary)
     get_primary_stream(*primary, array.data(), array.size() / PrimaryStreamSize, PrimaryStreamSize);
 }
 
+IG_EXPORT void ignis_cpu_get_second_primary_stream(PrimaryStream* primary, int size)
+{
+    auto& array = sInterface->getCPUSecondPrimaryStream(size);
+    get_primary_stream(*primary, array.data(), array.size() / PrimaryStreamSize, PrimaryStreamSize);
+}
+
+IG_EXPORT void ignis_cpu_swap_primary_streams()
+{
+    sInterface->swapCPUPrimaryStreams();
+}
+
+IG_EXPORT int ignis_cpu_prepare_tiles(int width, int height, int max_tile_size, int num_cores)
+{
+    return (int)sInterface->prepareTiles(width, height, max_tile_size, num_cores);
+}
+
+IG_EXPORT int ignis_cpu_acquire_tile(int* xmin, int* ymin, int* xmax, int* ymax)
+{
+    IG::TileRegion region{ 0, 0, 0, 0 };
+    const int id = sInterface->acquireTile(region);
+    *xmin        = region.XMin;
+    *ymin        = region.YMin;
+    *xmax        = region.XMax;
+    *ymax        = region.YMax;
+    return id;
+}
+
+IG_EXPORT void ignis_cpu_release_tile(int id)
+{
+    sInterface->releaseTile(id);
+}
+
+IG_EXPORT bool ignis_cpu_get_sample_mask(uint8_t** mask)
+{
+    *mask = const_cast<uint8_t*>(sInterface->getSampleMask());
+    return *mask != nullptr;
+}
+
 IG_EXPORT void ignis_cpu_get_secondary_stream(SecondaryStream* secondary, int size)
 {
     auto& array = sInterface->getCPUSecondaryStream(size);
@@ -1538,13 +1777,20 @@ IG_EXPORT void ignis_gpu_swap_secondary_streams(int dev)
     sInterface->swapGPUSecondaryStreams(dev);
 }
 
+// Only called around the work of a single tile
 IG_EXPORT void ignis_register_thread()
 {
     sInterface->registerThread();
+
+    if (sInterface->setup.acquire_timeline)
+        sInterface->getThreadData()->timeline.begin();
 }
 
 IG_EXPORT void ignis_unregister_thread()
 {
+    if (sInterface->setup.acquire_timeline)
+        sInterface->getThreadData()->timeline.end(IG::TimelineCategory::Tile, 0);
+
     sInterface->unregisterThread();
 }
 
@@ -1563,6 +1809,11 @@ IG_EXPORT void ignis_handle_hit_shader(int dev, int entity_id, int first, int la
     sInterface->runHitShader(dev, entity_id, first, last);
 }
 
+IG_EXPORT void ignis_handle_hit_shader_material(int dev, int material_id, int first, int last)
+{
+    sInterface->runHitShader(dev, -1, material_id, first, last);
+}
+
 IG_EXPORT void ignis_handle_advanced_shadow_shader(int dev, int material_id, int first, int last, bool is_hit)
 {
     if (sInterface->current_settings.info.ShadowHandlingMode == IG::ShadowHandlingMode::Advanced)
@@ -1604,23 +1855,27 @@ IG_EXPORT void ignis_get_parameter_color(const char* name, float defR, float def
     sInterface->getParameterColor(name, defR, defG, defB, defA, *r, *g, *b, *a);
 }
 
+// The block is only accessed from host code, like all the other parameter functions
+IG_EXPORT void ignis_get_parameter_block(float** block)
+{
+    *block = const_cast<float*>(sInterface->getParameterBlock());
+}
+
 // Stats
 IG_EXPORT void ignis_stats_begin_section(int id)
 {
-    if (!sInterface->setup.acquire_stats)
-        return;
-
-    // TODO
-    IG_UNUSED(id);
+    if (sInterface->setup.acquire_stats)
+        sInterface->getThreadData()->stats.beginSection((IG::SectionType)id);
+    if (sInterface->setup.acquire_timeline)
+        sInterface->getThreadData()->timeline.begin();
 }
 
 IG_EXPORT void ignis_stats_end_section(int id)
 {
-    if (!sInterface->setup.acquire_stats)
-        return;
-
-    // TODO
-    IG_UNUSED(id);
+    if (sInterface->setup.acquire_timeline)
+        sInterface->getThreadData()->timeline.end(IG::TimelineCategory::Section, (uint32_t)id);
+    if (sInterface->setup.acquire_stats)
+        sInterface->getThreadData()->stats.endSection((IG::SectionType)id);
 }
 
 IG_EXPORT void ignis_stats_add(int id, int value)
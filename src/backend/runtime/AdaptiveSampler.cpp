@@ -0,0 +1,104 @@
+#include "AdaptiveSampler.h"
+#include "Color.h"
+
+#include <algorithm>
+#include <cmath>
+
+IG_BEGIN_IGNORE_WARNINGS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+IG_END_IGNORE_WARNINGS
+
+namespace IG {
+AdaptiveSampler::AdaptiveSampler(float threshold, size_t warmupIterations)
+    : mThreshold(threshold)
+    , mWarmupIterations(std::max<size_t>(2, warmupIterations)) // At least two estimates are required for a variance
+    , mWidth(0)
+    , mHeight(0)
+    , mActivePixelCount(0)
+{
+}
+
+void AdaptiveSampler::resize(size_t width, size_t height)
+{
+    mWidth  = width;
+    mHeight = height;
+    mLuminance.resize(width * height);
+    mMask.resize(width * height);
+    reset();
+}
+
+void AdaptiveSampler::reset()
+{
+    std::fill(mLuminance.begin(), mLuminance.end(), 0.0f);
+    std::fill(mMask.begin(), mMask.end(), (uint8)1);
+    mActivePixelCount = mMask.size();
+}
+
+float AdaptiveSampler::relativeError(const float* film, const float* secondMoment, size_t pixel, size_t iterationCount)
+{
+    const float n        = (float)iterationCount;
+    const float mean     = RGB(film[3 * pixel + 0], film[3 * pixel + 1], film[3 * pixel + 2]).luminance() / n;
+    const float moment   = secondMoment[3 * pixel] / n;
+    const float variance = std::max(0.0f, moment - mean * mean);
+    return std::sqrt(variance / n) / std::max(std::abs(mean), MinMean);
+}
+
+void AdaptiveSampler::update(float* film, const std::vector<float*>& aovs, float* secondMoment, size_t iterationCount)
+{
+    IG_ASSERT(iterationCount > 0, "Expected at least one iteration to be rendered");
+
+    const bool updateMask = iterationCount >= mWarmupIterations;
+    // Adding the mean of the previous iterations keeps the mean of an inactive pixel unchanged
+    const float fillFactor = iterationCount > 1 ? 1.0f / (iterationCount - 1) : 0.0f;
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, mWidth * mHeight),
+        [&](tbb::blocked_range<size_t> r) {
+            for (size_t pixel = r.begin(); pixel < r.end(); ++pixel) {
+                float* rgb = &film[3 * pixel];
+                if (mMask[pixel]) {
+                    const float lum      = RGB(rgb[0], rgb[1], rgb[2]).luminance();
+                    const float estimate = lum - mLuminance[pixel];
+                    mLuminance[pixel]    = lum;
+                    for (int i = 0; i < 3; ++i)
+                        secondMoment[3 * pixel + i] += estimate * estimate;
+                } else {
+                    for (int i = 0; i < 3; ++i) {
+                        rgb[i] += rgb[i] * fillFactor;
+                        secondMoment[3 * pixel + i] += secondMoment[3 * pixel + i] * fillFactor;
+                        for (float* aov : aovs)
+                            aov[3 * pixel + i] += aov[3 * pixel + i] * fillFactor;
+                    }
+                    mLuminance[pixel] = RGB(rgb[0], rgb[1], rgb[2]).luminance();
+                }
+
+                // Written such that pixels with invalid values stay active
+                if (updateMask)
+                    mMask[pixel] = !(relativeError(film, secondMoment, pixel, iterationCount) < mThreshold);
+            }
+        });
+
+    mActivePixelCount = (size_t)std::count(mMask.begin(), mMask.end(), (uint8)1);
+}
+
+bool AdaptiveSampler::isActive(const TileRegion& region) const
+{
+    for (int32 y = region.YMin; y < region.YMax; ++y) {
+        const uint8* row = &mMask[(size_t)y * mWidth];
+        if (std::any_of(row + region.XMin, row + region.XMax, [](uint8 active) { return active != 0; }))
+            return true;
+    }
+    return false;
+}
+
+bool AdaptiveSampler::isFullyActive(const TileRegion& region) const
+{
+    for (int32 y = region.YMin; y < region.YMax; ++y) {
+        const uint8* row = &mMask[(size_t)y * mWidth];
+        if (std::any_of(row + region.XMin, row + region.XMax, [](uint8 active) { return active == 0; }))
+            return false;
+    }
+    return true;
+}
+} // namespace IG
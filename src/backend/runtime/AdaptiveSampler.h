@@ -0,0 +1,55 @@
+#pragma once
+
+#include "TileScheduler.h"
+
+#include <vector>
+
+namespace IG {
+/// Decides per pixel if more samples are necessary, based on the variance of the per-iteration estimates of the luminance.
+/// The framebuffer and all AOVs are expected to contain the sum of the per-iteration estimates, as the frontends divide by the number of iterations.
+/// Pixels without samples in an iteration get their current mean added to all buffers, such that the division stays valid.
+/// The mask is only updated between iterations and is constant while rendering
+class AdaptiveSampler {
+public:
+    static constexpr float MinMean = 1e-3f; // Lower bound for the mean luminance in the relative error, such that dark pixels are able to converge
+
+    AdaptiveSampler(float threshold, size_t warmupIterations);
+
+    /// Discard all estimates and mark all pixels as active
+    void resize(size_t width, size_t height);
+    /// Same as above, without changing the size
+    void reset();
+
+    /// Update the estimates after an iteration was rendered into the given buffers. The iteration count includes the latest iteration.
+    /// The squared luminance of the latest estimate is added to each channel of the second moment buffer.
+    /// The mask is recomputed after the warm-up iterations
+    void update(float* film, const std::vector<float*>& aovs, float* secondMoment, size_t iterationCount);
+
+    /// Relative standard error of the mean luminance of the given pixel
+    static float relativeError(const float* film, const float* secondMoment, size_t pixel, size_t iterationCount);
+
+    inline bool isActive(size_t x, size_t y) const { return mMask[y * mWidth + x] != 0; }
+    /// True if at least one pixel of the region is active
+    bool isActive(const TileRegion& region) const;
+    /// True if all pixels of the region are active, in which case the mask can be ignored
+    bool isFullyActive(const TileRegion& region) const;
+
+    /// One entry per pixel, zero if the pixel converged
+    inline const uint8* mask() const { return mMask.data(); }
+    inline size_t activePixelCount() const { return mActivePixelCount; }
+
+    inline float threshold() const { return mThreshold; }
+    inline size_t warmupIterations() const { return mWarmupIterations; }
+
+private:
+    float mThreshold;
+    size_t mWarmupIterations;
+
+    size_t mWidth;
+    size_t mHeight;
+
+    std::vector<float> mLuminance; // Luminance of the accumulated framebuffer after the last update
+    std::vector<uint8> mMask;
+    size_t mActivePixelCount;
+};
+} // namespace IG
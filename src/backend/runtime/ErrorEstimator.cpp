@@ -0,0 +1,86 @@
+#include "ErrorEstimator.h"
+#include "Color.h"
+
+#include <cmath>
+
+IG_BEGIN_IGNORE_WARNINGS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+IG_END_IGNORE_WARNINGS
+
+namespace IG {
+ErrorEstimator::ErrorEstimator()
+    : mSnapshotIterations{ 0, 0 }
+    , mReferenceIteration(0)
+{
+}
+
+float ErrorEstimator::update(const float* pixels, size_t pixelCount, size_t iteration)
+{
+    // The framebuffer got resized or reset
+    if (mSnapshots[1].size() != pixelCount || mSnapshotIterations[1] > iteration) {
+        for (size_t i = 0; i < 2; ++i) {
+            mSnapshots[i].resize(pixelCount);
+            mSnapshotIterations[i] = 0;
+        }
+    }
+
+    // Use the latest snapshot covering at most half of the iterations, such that both estimates have a similar variance
+    float error         = -1;
+    mReferenceIteration = 0;
+    for (size_t i = 2; i > 0; --i) {
+        const size_t snapshotIteration = mSnapshotIterations[i - 1];
+        if (snapshotIteration >= MinIterations && 2 * snapshotIteration <= iteration) {
+            error               = computeError(pixels, mSnapshots[i - 1], snapshotIteration, iteration);
+            mReferenceIteration = snapshotIteration;
+            break;
+        }
+    }
+
+    if (iteration > 0 && (iteration & (iteration - 1)) == 0) {
+        std::swap(mSnapshots[0], mSnapshots[1]);
+        mSnapshotIterations[0] = mSnapshotIterations[1];
+        mSnapshotIterations[1] = iteration;
+
+        auto& snapshot = mSnapshots[1];
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, pixelCount),
+                          [&](tbb::blocked_range<size_t> r) {
+                              for (size_t k = r.begin(); k < r.end(); ++k)
+                                  snapshot[k] = RGB(pixels[3 * k + 0], pixels[3 * k + 1], pixels[3 * k + 2]).luminance();
+                          });
+    }
+
+    return error;
+}
+
+float ErrorEstimator::computeError(const float* pixels, const std::vector<float>& snapshot, size_t snapshotIteration, size_t iteration) const
+{
+    if (snapshot.empty())
+        return 0;
+
+    const float h = (float)snapshotIteration;
+    const float n = (float)iteration;
+    // The variance of the difference is (1/h + 1/(n-h)) times the variance of a single iteration, the variance of the mean is 1/n times the variance
+    const float factor = 1 / (n * (1 / h + 1 / (n - h)));
+
+    const double sum = tbb::parallel_reduce(
+        tbb::blocked_range<size_t>(0, snapshot.size()), 0.0,
+        [&](tbb::blocked_range<size_t> r, double partial) {
+            for (size_t k = r.begin(); k < r.end(); ++k) {
+                const float total  = RGB(pixels[3 * k + 0], pixels[3 * k + 1], pixels[3 * k + 2]).luminance();
+                const float first  = snapshot[k] / h;
+                const float second = (total - snapshot[k]) / (n - h);
+                const float mean   = total / n;
+                const float diff   = first - second;
+                const float error  = factor * diff * diff / (mean * mean + Epsilon);
+                if (std::isfinite(error))
+                    partial += error;
+            }
+            return partial;
+        },
+        std::plus<double>());
+
+    return (float)std::sqrt(sum / snapshot.size());
+}
+} // namespace IG
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "IG_Config.h"
+
+namespace IG {
+/// Estimates the relative error of the rendered image from the accumulated framebuffer alone, therefore it works with every technique and target.
+/// The luminance of the framebuffer is stored at power of two iterations. The mean of the iterations up to such a snapshot and the mean of the iterations
+/// after it are independent estimates, and their difference is proportional to the standard error of the mean of all iterations
+class ErrorEstimator {
+public:
+    static constexpr float Epsilon        = 0.01f; // Added to the squared mean, such that dark pixels do not dominate the error
+    static constexpr size_t MinIterations = 4;     // Minimum number of iterations for each of the two estimates, as fewer give unreliable results
+
+    ErrorEstimator();
+
+    /// Update with the accumulated framebuffer (rgb) after the given number of iterations. The snapshots are discarded if the size changed or the iteration count decreased.
+    /// Returns the relative root mean squared error or a negative value if not enough iterations are rendered yet
+    float update(const float* pixels, size_t pixelCount, size_t iteration);
+
+    /// Iteration of the snapshot used by the last update or zero if none was used
+    inline size_t referenceIteration() const { return mReferenceIteration; }
+
+private:
+    float computeError(const float* pixels, const std::vector<float>& snapshot, size_t snapshotIteration, size_t iteration) const;
+
+    std::array<std::vector<float>, 2> mSnapshots; // Luminance of the accumulated framebuffer, the newer one is last
+    std::array<size_t, 2> mSnapshotIterations;
+    size_t mReferenceIteration;
+};
+} // namespace IG
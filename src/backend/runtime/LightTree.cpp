@@ -0,0 +1,139 @@
+#include "LightTree.h"
+#include "Logger.h"
+#include "serialization/VectorSerializer.h"
+
+namespace IG {
+
+void LightTree::addFinite(uint32 id, const BoundingBox& bbox, const Vector3f& axis, float thetaO, float thetaE, float power)
+{
+    mFinite.push_back(LightBounds{ bbox, axis.normalized(), std::min(thetaO, Pi), std::min(thetaE, Pi / 2), power, (int32)id });
+}
+
+void LightTree::addInfinite(uint32 id, float power)
+{
+    mInfinite.emplace_back(id, power);
+}
+
+float LightTree::infiniteProbability() const
+{
+    if (mInfinite.empty())
+        return 0;
+    if (mFinite.empty())
+        return 1;
+
+    float finitePower = 0;
+    for (const auto& light : mFinite)
+        finitePower += light.Power;
+
+    float infinitePower = 0;
+    for (const auto& light : mInfinite)
+        infinitePower += light.second;
+
+    const float sum = finitePower + infinitePower;
+    return sum > FltEps ? infinitePower / sum : 0.5f;
+}
+
+// Union of two bounding cones, see "Importance Sampling of Many Lights with Adaptive Tree Splitting" [Conty & Kulla 2018]
+LightTree::LightBounds LightTree::merge(const LightBounds& a, const LightBounds& b)
+{
+    LightBounds bounds;
+    bounds.BBox   = BoundingBox(a.BBox).extend(b.BBox);
+    bounds.ThetaE = std::max(a.ThetaE, b.ThetaE);
+    bounds.Power  = a.Power + b.Power;
+    bounds.ID     = -1;
+
+    const float thetaD = std::acos(std::clamp(a.Axis.dot(b.Axis), -1.0f, 1.0f));
+    if (std::min(thetaD + b.ThetaO, Pi) <= a.ThetaO) {
+        bounds.Axis   = a.Axis;
+        bounds.ThetaO = a.ThetaO;
+    } else if (std::min(thetaD + a.ThetaO, Pi) <= b.ThetaO) {
+        bounds.Axis   = b.Axis;
+        bounds.ThetaO = b.ThetaO;
+    } else {
+        const float thetaO = (a.ThetaO + thetaD + b.ThetaO) / 2;
+        const Vector3f rot = a.Axis.cross(b.Axis);
+        if (thetaO >= Pi || rot.squaredNorm() <= FltEps * FltEps) {
+            bounds.Axis   = a.Axis;
+            bounds.ThetaO = Pi;
+        } else {
+            // Rotate the axis of a towards b, such that the new cone contains both
+            bounds.Axis   = Eigen::AngleAxisf(thetaO - a.ThetaO, rot.normalized()) * a.Axis;
+            bounds.ThetaO = thetaO;
+        }
+    }
+
+    return bounds;
+}
+
+int32 LightTree::buildNode(size_t begin, size_t end, uint32 trail, size_t depth)
+{
+    IG_ASSERT(begin < end, "Expected non-empty range of lights");
+    IG_ASSERT(depth < 32, "Expected trail to fit into 32 bits");
+
+    const int32 index = (int32)mNodes.size();
+    mNodes.emplace_back();
+
+    if (end - begin == 1) {
+        mNodes[index]              = Node{ mFinite[begin], -1, -1 };
+        mTrails[mFinite[begin].ID] = trail;
+        return index;
+    }
+
+    // Split at the median of the largest extent of the centroids. This keeps the tree balanced, such that the trail of a leaf is bounded by the depth
+    BoundingBox centroids = BoundingBox::Empty();
+    for (size_t i = begin; i < end; ++i)
+        centroids.extend(mFinite[i].BBox.center());
+
+    int axis;
+    centroids.diameter().maxCoeff(&axis);
+
+    const size_t mid = begin + (end - begin) / 2;
+    std::nth_element(mFinite.begin() + begin, mFinite.begin() + mid, mFinite.begin() + end,
+                     [axis](const LightBounds& a, const LightBounds& b) { return a.BBox.center()[axis] < b.BBox.center()[axis]; });
+
+    const int32 left  = buildNode(begin, mid, trail, depth + 1);
+    const int32 right = buildNode(mid, end, trail | (1u << depth), depth + 1);
+
+    mNodes[index] = Node{ merge(mNodes[left].Bounds, mNodes[right].Bounds), left, right };
+    return index;
+}
+
+void LightTree::build(std::vector<uint8>& data, size_t lightCount)
+{
+    mNodes.clear();
+    mTrails.assign(lightCount, 0);
+
+    if (!mFinite.empty()) {
+        mNodes.reserve(2 * mFinite.size() - 1);
+        buildNode(0, mFinite.size(), 0, 0);
+    }
+
+    std::vector<bool> inTree(lightCount, false);
+    for (const auto& light : mFinite)
+        inTree[light.ID] = true;
+
+    IG_LOG(L_DEBUG) << "Light tree with " << mNodes.size() << " nodes over " << mFinite.size() << " finite lights and " << mInfinite.size() << " infinite lights" << std::endl;
+
+    VectorSerializer serializer(data, false);
+    for (const auto& node : mNodes) {
+        serializer.write(node.Bounds.BBox.min);  // +3 = 3
+        serializer.write(node.Bounds.Power);     // +1 = 4
+        serializer.write(node.Bounds.BBox.max);  // +3 = 7
+        serializer.write(node.Bounds.ThetaO);    // +1 = 8
+        serializer.write(node.Bounds.Axis);      // +3 = 11
+        serializer.write(node.Bounds.ThetaE);    // +1 = 12
+        serializer.write(node.Left);             // +1 = 13
+        serializer.write(node.Right);            // +1 = 14
+        serializer.write(node.Bounds.ID);        // +1 = 15
+        serializer.write((uint32)0 /*Padding*/); // +1 = 16
+    }
+
+    for (size_t id = 0; id < lightCount; ++id) {
+        serializer.write(mTrails[id]);                  // +1 = 1
+        serializer.write((uint32)(inTree[id] ? 1 : 0)); // +1 = 2
+    }
+
+    for (const auto& light : mInfinite)
+        serializer.write(light.first);
+}
+} // namespace IG
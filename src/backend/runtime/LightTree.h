@@ -0,0 +1,51 @@
+#pragma once
+
+#include "math/BoundingBox.h"
+
+namespace IG {
+/// Bounding cone hierarchy over all finite lights, which allows to select lights based on the shading point.
+/// Lights without spatial bounds (e.g., environment lights) are stored in a separate list and selected uniformly
+class LightTree {
+public:
+    /// Add a light with finite spatial extent. The emission is bounded by the cone given by axis and the angles thetaO (spread of normals) and thetaE (emission around normals)
+    void addFinite(uint32 id, const BoundingBox& bbox, const Vector3f& axis, float thetaO, float thetaE, float power);
+    /// Add a light without spatial bounds
+    void addInfinite(uint32 id, float power);
+
+    /// Build the hierarchy and serialize it into the given buffer. See light_selector.art for the layout.
+    /// The number of lights has to cover all ids given to the add functions
+    void build(std::vector<uint8>& data, size_t lightCount);
+
+    /// Number of nodes in the hierarchy. Only valid after build
+    inline size_t nodeCount() const { return mNodes.size(); }
+    /// Number of lights without spatial bounds
+    inline size_t infiniteCount() const { return mInfinite.size(); }
+    /// Probability to select a light without spatial bounds instead of traversing the hierarchy
+    float infiniteProbability() const;
+
+private:
+    struct LightBounds {
+        BoundingBox BBox;
+        Vector3f Axis;
+        float ThetaO;
+        float ThetaE;
+        float Power;
+        int32 ID; // -1 for inner nodes
+    };
+
+    struct Node {
+        LightBounds Bounds;
+        int32 Left;
+        int32 Right;
+    };
+
+    static LightBounds merge(const LightBounds& a, const LightBounds& b);
+    int32 buildNode(size_t begin, size_t end, uint32 trail, size_t depth);
+
+    std::vector<LightBounds> mFinite;
+    std::vector<std::pair<uint32, float>> mInfinite;
+
+    std::vector<Node> mNodes;
+    std::vector<uint32> mTrails; // Bit trail from the root to the leaf of each light (0 = left, 1 = right)
+};
+} // namespace IG
@@ -0,0 +1,103 @@
+#include "ParameterSet.h"
+
+#include <cstring>
+
+namespace IG {
+static inline float intAsFloat(int value)
+{
+    float f;
+    std::memcpy(&f, &value, sizeof(f));
+    return f;
+}
+
+template <typename T>
+static inline T lookup(const std::unordered_map<std::string, T>& map, const std::string& name, const T& def)
+{
+    const auto it = map.find(name);
+    return it != map.end() ? it->second : def;
+}
+
+size_t ParameterSet::acquireSlot(const std::string& name, bool& created)
+{
+    const auto it = Slots.find(name);
+    if (it != Slots.end()) {
+        created = false;
+        return it->second;
+    }
+
+    const size_t slot = Slots.size();
+    Slots[name]       = slot;
+    Block.resize(Block.size() + SlotSize, 0.0f);
+    created = true;
+    return slot;
+}
+
+void ParameterSet::writeSlot(const std::string& name, const Vector4f& value)
+{
+    const auto it = Slots.find(name);
+    if (it != Slots.end())
+        std::memcpy(&Block[it->second * SlotSize], value.data(), sizeof(float) * SlotSize);
+}
+
+size_t ParameterSet::resolveInt(const std::string& name, int def)
+{
+    bool created;
+    const size_t slot = acquireSlot(name, created);
+    if (created)
+        writeSlot(name, Vector4f(intAsFloat(lookup(IntParameters, name, def)), 0, 0, 0));
+    return slot;
+}
+
+size_t ParameterSet::resolveFloat(const std::string& name, float def)
+{
+    bool created;
+    const size_t slot = acquireSlot(name, created);
+    if (created)
+        writeSlot(name, Vector4f(lookup(FloatParameters, name, def), 0, 0, 0));
+    return slot;
+}
+
+size_t ParameterSet::resolveVector(const std::string& name, const Vector3f& def)
+{
+    bool created;
+    const size_t slot = acquireSlot(name, created);
+    if (created) {
+        const Vector3f value = lookup(VectorParameters, name, def);
+        writeSlot(name, Vector4f(value.x(), value.y(), value.z(), 0));
+    }
+    return slot;
+}
+
+size_t ParameterSet::resolveColor(const std::string& name, const Vector4f& def)
+{
+    bool created;
+    const size_t slot = acquireSlot(name, created);
+    if (created)
+        writeSlot(name, lookup(ColorParameters, name, def));
+    return slot;
+}
+
+void ParameterSet::setInt(const std::string& name, int value)
+{
+    IntParameters[name] = value;
+    writeSlot(name, Vector4f(intAsFloat(value), 0, 0, 0));
+}
+
+void ParameterSet::setFloat(const std::string& name, float value)
+{
+    FloatParameters[name] = value;
+    writeSlot(name, Vector4f(value, 0, 0, 0));
+}
+
+void ParameterSet::setVector(const std::string& name, const Vector3f& value)
+{
+    VectorParameters[name] = value;
+    writeSlot(name, Vector4f(value.x(), value.y(), value.z(), 0));
+}
+
+void ParameterSet::setColor(const std::string& name, const Vector4f& value)
+{
+    ColorParameters[name] = value;
+    writeSlot(name, value);
+}
+} // namespace IG
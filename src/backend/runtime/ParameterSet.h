@@ -0,0 +1,42 @@
+#pragma once
+
+#include "IG_Config.h"
+
+namespace IG {
+/// Parameters set by the runtime and accessed by the shaders.
+/// Parameters used while generating shaders are resolved to a stable slot in a flat block,
+/// such that the access in the shader is a plain load instead of a lookup by name
+struct ParameterSet {
+    std::unordered_map<std::string, int> IntParameters;
+    std::unordered_map<std::string, float> FloatParameters;
+    std::unordered_map<std::string, Vector3f> VectorParameters;
+    std::unordered_map<std::string, Vector4f> ColorParameters;
+
+    std::unordered_map<std::string, size_t> Slots; // Name to slot in the block
+    std::vector<float> Block;                      // Four floats per slot. Integers are stored bitwise
+
+    static constexpr size_t SlotSize = 4;
+
+    /// Resolve the parameter to a slot. A new slot is initialized with the current value of the parameter or the given default if not set yet
+    size_t resolveInt(const std::string& name, int def);
+    /// Resolve the parameter to a slot. See resolveInt
+    size_t resolveFloat(const std::string& name, float def);
+    /// Resolve the parameter to a slot. See resolveInt
+    size_t resolveVector(const std::string& name, const Vector3f& def);
+    /// Resolve the parameter to a slot. See resolveInt
+    size_t resolveColor(const std::string& name, const Vector4f& def);
+
+    /// Set parameter and update its slot if available
+    void setInt(const std::string& name, int value);
+    /// Set parameter and update its slot if available
+    void setFloat(const std::string& name, float value);
+    /// Set parameter and update its slot if available
+    void setVector(const std::string& name, const Vector3f& value);
+    /// Set parameter and update its slot if available
+    void setColor(const std::string& name, const Vector4f& value);
+
+private:
+    size_t acquireSlot(const std::string& name, bool& created);
+    void writeSlot(const std::string& name, const Vector4f& value);
+};
+} // namespace IG
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "IG_Config.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace IG {
+/// Decides when to stop rendering. The budget is given as a number of iterations, a time in milliseconds and a relative error, each is disabled if zero.
+/// The budget is exhausted as soon as one of the limits is met. The time of the next iteration is estimated from the previous ones,
+/// such that the time budget is not exceeded by a whole iteration
+class RenderBudget {
+public:
+    static constexpr float CostSmoothing = 0.25f; // Weight of the newest iteration in the estimated cost per iteration
+
+    RenderBudget(size_t maxIterations, float timeBudgetMS, float targetError)
+        : mMaxIterations(maxIterations)
+        , mTimeBudgetMS(timeBudgetMS)
+        , mTargetError(targetError)
+        , mIterations(0)
+        , mElapsedMS(0)
+        , mIterationMS(0)
+        , mError(-1)
+    {
+    }
+
+    /// Register a finished iteration, which took the given time including all work done between iterations
+    inline void addIteration(float elapsedMS)
+    {
+        mElapsedMS += elapsedMS;
+        mIterationMS = mIterations == 0 ? elapsedMS : (1 - CostSmoothing) * mIterationMS + CostSmoothing * elapsedMS;
+        ++mIterations;
+    }
+
+    /// Set the current error estimate. A negative value denotes an unknown error
+    inline void setError(float error) { mError = error; }
+
+    inline bool isExhausted() const
+    {
+        if (mMaxIterations > 0 && mIterations >= mMaxIterations)
+            return true;
+        if (mTargetError > 0 && mError >= 0 && mError <= mTargetError)
+            return true;
+        if (mTimeBudgetMS > 0 && mElapsedMS + mIterationMS > mTimeBudgetMS)
+            return true;
+        return false;
+    }
+
+    /// Estimated number of iterations until the budget is exhausted. Zero if unknown.
+    /// The error is expected to decrease with the square root of the number of iterations
+    inline size_t estimateRemainingIterations() const
+    {
+        if (isExhausted())
+            return 0;
+
+        size_t remaining = std::numeric_limits<size_t>::max();
+        if (mMaxIterations > 0)
+            remaining = mMaxIterations - mIterations;
+
+        if (mTimeBudgetMS > 0 && mIterationMS > 0)
+            remaining = std::min(remaining, (size_t)((mTimeBudgetMS - mElapsedMS) / mIterationMS));
+
+        if (mTargetError > 0 && mError > 0) {
+            const float ratio = mError / mTargetError;
+            remaining         = std::min(remaining, (size_t)std::ceil(mIterations * ratio * ratio) - mIterations);
+        }
+
+        return remaining == std::numeric_limits<size_t>::max() ? 0 : remaining;
+    }
+
+    inline size_t iterations() const { return mIterations; }
+    inline float elapsedMS() const { return mElapsedMS; }
+    inline float error() const { return mError; }
+
+    inline bool hasTargetError() const { return mTargetError > 0; }
+    /// True if the number of iterations or the time is limited. The error alone might never reach the target
+    inline bool isBounded() const { return mMaxIterations > 0 || mTimeBudgetMS > 0; }
+
+private:
+    const size_t mMaxIterations;
+    const float mTimeBudgetMS;
+    const float mTargetError;
+
+    size_t mIterations;
+    float mElapsedMS;
+    float mIterationMS; // Smoothed cost of a single iteration
+    float mError;
+};
+} // namespace IG
@@ -2,8 +2,16 @@
 #include "Logger.h"
 #include "loader/Parser.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <fstream>
+#include <future>
+#include <unordered_map>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
 
 namespace IG {
 
@@ -40,6 +48,19 @@ static inline void setup_film(LoaderOptions& lopts, const RuntimeOptions& opts)
         lopts.PixelSamplerType = to_lowercase(film->property("sampler").getString(lopts.PixelSamplerType));
 }
 
+static inline void setup_bvh(LoaderOptions& lopts, const RuntimeOptions& opts)
+{
+    lopts.BVHOptions = BvhBuildOptions::makeQuality();
+    if (opts.BVHPreset.empty())
+        return;
+
+    const auto preset = BvhBuildOptions::fromPreset(opts.BVHPreset);
+    if (preset.has_value())
+        lopts.BVHOptions = preset.value();
+    else
+        IG_LOG(L_WARNING) << "Unknown BVH preset '" << opts.BVHPreset << "'. Using 'quality' instead" << std::endl;
+}
+
 static inline void setup_camera(LoaderOptions& lopts, const RuntimeOptions& opts)
 {
     // Extract camera type
@@ -83,11 +104,17 @@ Runtime::Runtime(const RuntimeOptions& opts)
     , mCurrentIteration(0)
     , mCurrentSampleCount(0)
     , mCurrentFrame(0)
+    , mCurrentRayGeneration(0)
+    , mTracedRays(nullptr)
+    , mTracedRaysNormalized(false)
     , mFilmWidth(0)
     , mFilmHeight(0)
     , mCameraName()
     , mInitialCameraOrientation()
     , mAcquireStats(opts.AcquireStats)
+    , mAcquireTimeline(opts.AcquireTimeline)
+    , mAdaptiveSampling(false)
+    , mLoadingTimings()
     , mTechniqueName()
     , mTechniqueInfo()
     , mTechniqueVariants()
@@ -145,9 +172,10 @@ bool Runtime::loadFromFile(const std::filesystem::path& path)
     IG_LOG(L_DEBUG) << "Parsing scene file" << std::endl;
     const auto startParser = std::chrono::high_resolution_clock::now();
     Parser::SceneParser parser;
-    bool ok    = false;
-    auto scene = parser.loadFromFile(path, ok);
-    IG_LOG(L_DEBUG) << "Parsing scene took " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startParser).count() / 1000.0f << " seconds" << std::endl;
+    bool ok                 = false;
+    auto scene              = parser.loadFromFile(path, ok);
+    mLoadingTimings.ParseMS = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startParser).count();
+    IG_LOG(L_DEBUG) << "Parsing scene took " << mLoadingTimings.ParseMS / 1000.0f << " seconds" << std::endl;
     if (!ok)
         return false;
 
@@ -163,9 +191,10 @@ bool Runtime::loadFromString(const std::string& str)
     IG_LOG(L_DEBUG) << "Parsing scene string" << std::endl;
     const auto startParser = std::chrono::high_resolution_clock::now();
     Parser::SceneParser parser;
-    bool ok    = false;
-    auto scene = parser.loadFromString(str, ok);
-    IG_LOG(L_DEBUG) << "Parsing scene took " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startParser).count() / 1000.0f << " seconds" << std::endl;
+    bool ok                 = false;
+    auto scene              = parser.loadFromString(str, ok);
+    mLoadingTimings.ParseMS = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startParser).count();
+    IG_LOG(L_DEBUG) << "Parsing scene took " << mLoadingTimings.ParseMS / 1000.0f << " seconds" << std::endl;
     if (!ok)
         return false;
 
@@ -183,6 +212,10 @@ bool Runtime::load(const std::filesystem::path& path, Parser::Scene&& scene)
     lopts.IsTracer = mOptions.IsTracer;
     lopts.Scene    = std::move(scene);
 
+    lopts.UseMaterialParameterTable = mOptions.UseMaterialParameterTable;
+    lopts.SceneCacheDir             = mOptions.SceneCacheDir;
+    lopts.SortPrimaryByMaterial     = mOptions.SortPrimaryByMaterial && isCPU(mTarget); // Has to match the driver setup
+
     // Extract technique
     setup_technique(lopts, mOptions);
 
@@ -194,6 +227,9 @@ bool Runtime::load(const std::filesystem::path& path, Parser::Scene&& scene)
     // Extract camera
     setup_camera(lopts, mOptions);
 
+    // Extract bvh options
+    setup_bvh(lopts, mOptions);
+
     if (mOptions.SPI == 0)
         mSamplesPerIteration = recommendSPI(mTarget, mFilmWidth, mFilmHeight, mOptions.IsInteractive);
     else
@@ -208,13 +244,24 @@ bool Runtime::load(const std::filesystem::path& path, Parser::Scene&& scene)
     if (!Loader::load(lopts, result))
         return false;
     mDatabase = std::move(result.Database);
-    IG_LOG(L_DEBUG) << "Loading scene took " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startLoader).count() / 1000.0f << " seconds" << std::endl;
+
+    const size_t parseMS     = mLoadingTimings.ParseMS;
+    mLoadingTimings          = result.Timings;
+    mLoadingTimings.ParseMS  = parseMS;
+    mLoadingTimings.LoaderMS = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startLoader).count();
+    IG_LOG(L_DEBUG) << "Loading scene took " << mLoadingTimings.LoaderMS / 1000.0f << " seconds" << std::endl;
 
     mCameraName               = lopts.CameraType;
     mTechniqueName            = lopts.TechniqueType;
     mTechniqueInfo            = result.TechniqueInfo;
     mInitialCameraOrientation = result.CameraOrientation;
     mTechniqueVariants        = std::move(result.TechniqueVariants);
+    mParameterSet             = std::move(result.Parameters);
+
+    // The second moment is accumulated like any other AOV, but is only handled by the driver
+    mAdaptiveSampling = mOptions.AdaptiveThreshold > 0 && checkAdaptiveSampling();
+    if (mAdaptiveSampling)
+        mTechniqueInfo.EnabledAOVs.emplace_back("Second Moment");
 
     return setup();
 }
@@ -269,6 +316,11 @@ void Runtime::stepVariant(size_t variant)
 }
 
 void Runtime::trace(const std::vector<Ray>& rays, std::vector<float>& data)
+{
+    trace(rays.data(), rays.size(), data, false);
+}
+
+void Runtime::trace(const Ray* rays, size_t count, std::vector<float>& data, bool normalized, bool reuseRays)
 {
     if (!mOptions.IsTracer) {
         IG_LOG(L_ERROR) << "Trying to use trace() in a camera driver!" << std::endl;
@@ -280,24 +332,98 @@ void Runtime::trace(const std::vector<Ray>& rays, std::vector<float>& data)
         return;
     }
 
+    if (count == 0) {
+        data.clear();
+        return;
+    }
+
+    // The framebuffer is bound to the number of rays. This will reset the runtime if a resize is necessary,
+    // but keeps the scene and the compiled shaders resident
+    if (mFilmWidth != count || mFilmHeight != 1)
+        resizeFramebuffer(count, 1);
+
+    // The driver checks the number of rays itself
+    if (!reuseRays || rays != mTracedRays || normalized != mTracedRaysNormalized) {
+        ++mCurrentRayGeneration;
+        mTracedRays           = rays;
+        mTracedRaysNormalized = normalized;
+    }
+    traceIteration(rays, count, normalized);
+
+    // Get result
+    const float* data_ptr = getFramebuffer(0);
+    data.resize(count * 3);
+    std::memcpy(data.data(), data_ptr, sizeof(float) * count * 3);
+}
+
+size_t Runtime::traceStream(const RayStreamSource& source, const RayStreamSink& sink, size_t chunkSize, size_t iterations, bool normalized)
+{
+    if (!mOptions.IsTracer) {
+        IG_LOG(L_ERROR) << "Trying to use traceStream() in a camera driver!" << std::endl;
+        return 0;
+    }
+
+    if (mTechniqueVariants.empty()) {
+        IG_LOG(L_ERROR) << "No scene loaded!" << std::endl;
+        return 0;
+    }
+
+    if (chunkSize == 0) {
+        IG_LOG(L_ERROR) << "Expected a chunk size greater than zero" << std::endl;
+        return 0;
+    }
+
+    // The framebuffer is bound to the chunk size once. A smaller last chunk only uses a part of it
+    if (mFilmWidth != chunkSize || mFilmHeight != 1)
+        resizeFramebuffer(chunkSize, 1);
+
+    // Two host buffers: One is traced, while the other one is filled by the source
+    std::array<std::vector<Ray>, 2> chunks;
+    for (auto& chunk : chunks)
+        chunk.resize(chunkSize);
+
+    const auto produce = [&](size_t index) { return std::min(chunkSize, source(chunks[index].data(), chunkSize)); };
+
+    size_t current = 0;
+    size_t count   = produce(current);
+    size_t total   = 0;
+    while (count > 0) {
+        const size_t next = 1 - current;
+        auto pending      = std::async(std::launch::async, produce, next);
+
+        reset();
+        ++mCurrentRayGeneration;
+        for (size_t iter = 0; iter < std::max<size_t>(1, iterations); ++iter)
+            traceIteration(chunks[current].data(), count, normalized);
+
+        sink(getFramebuffer(0), count);
+        total += count;
+
+        count   = pending.get();
+        current = next;
+    }
+
+    // The rays of the driver belong to the last chunk now
+    mTracedRays = nullptr;
+
+    return total;
+}
+
+void Runtime::traceIteration(const Ray* rays, size_t count, bool normalized)
+{
     if (mTechniqueInfo.VariantSelector) {
         const auto& active = mTechniqueInfo.VariantSelector(mCurrentIteration);
         for (const auto& ind : active)
-            traceVariant(rays, ind);
+            traceVariant(rays, count, normalized, ind);
     } else {
         for (size_t i = 0; i < mTechniqueVariants.size(); ++i)
-            traceVariant(rays, i);
+            traceVariant(rays, count, normalized, i);
     }
 
     ++mCurrentIteration;
-
-    // Get result
-    const float* data_ptr = getFramebuffer(0);
-    data.resize(rays.size() * 3);
-    std::memcpy(data.data(), data_ptr, sizeof(float) * rays.size() * 3);
 }
 
-void Runtime::traceVariant(const std::vector<Ray>& rays, size_t variant)
+void Runtime::traceVariant(const Ray* rays, size_t count, bool normalized, size_t variant)
 {
     IG_ASSERT(variant < mTechniqueVariants.size(), "Expected technique variant to be well selected");
     const auto& info = mTechniqueInfo.Variants[variant];
@@ -305,12 +431,14 @@ void Runtime::traceVariant(const std::vector<Ray>& rays, size_t variant)
     // IG_LOG(L_DEBUG) << "Tracing iteration " << mCurrentIteration << ", variant " << variant << std::endl;
 
     DriverRenderSettings settings;
-    settings.rays        = rays.data();
-    settings.device      = mDevice;
-    settings.spi         = info.GetSPI(mSamplesPerIteration);
-    settings.work_width  = rays.size();
-    settings.work_height = 1;
-    settings.info        = info;
+    settings.rays            = rays;
+    settings.ray_generation  = mCurrentRayGeneration;
+    settings.rays_normalized = normalized;
+    settings.device          = mDevice;
+    settings.spi             = info.GetSPI(mSamplesPerIteration);
+    settings.work_width      = count;
+    settings.work_height     = 1;
+    settings.info            = info;
 
     setParameter("__spi", (int)settings.spi);
     mLoadedInterface.RenderFunction(mTechniqueVariantShaderSets[variant], settings, &mParameterSet, mCurrentIteration, mCurrentFrame);
@@ -350,22 +478,67 @@ void Runtime::reset()
     // No mCurrentFrameCount
 }
 
+size_t Runtime::activePixelCount() const
+{
+    return mLoadedInterface.ActivePixelCountFunction();
+}
+
+bool Runtime::checkAdaptiveSampling() const
+{
+    // The driver expects the framebuffer to contain exactly one estimate per pixel and iteration
+    if (!isCPU(mTarget)) {
+        IG_LOG(L_WARNING) << "Adaptive sampling is only available on the CPU. Disabling it" << std::endl;
+        return false;
+    }
+
+    if (mOptions.IsTracer) {
+        IG_LOG(L_WARNING) << "Adaptive sampling is not available in tracing mode. Disabling it" << std::endl;
+        return false;
+    }
+
+    const bool singlePass = mTechniqueInfo.Variants.size() == 1 && mTechniqueInfo.VariantSelector == nullptr;
+    if (!singlePass || mTechniqueInfo.Variants[0].LockFramebuffer || mTechniqueInfo.Variants[0].OverrideWidth.has_value() || mTechniqueInfo.Variants[0].OverrideHeight.has_value()) {
+        IG_LOG(L_WARNING) << "Adaptive sampling is not available for technique '" << mTechniqueName << "' as it uses multiple passes. Disabling it" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
 const Statistics* Runtime::getStatistics() const
 {
     return mAcquireStats ? mLoadedInterface.GetStatisticsFunction() : nullptr;
 }
 
+std::string Runtime::getStatisticsAsJSON(size_t totalMS) const
+{
+    const Statistics* stats = getStatistics();
+    return stats ? stats->dumpAsJSON(totalMS, mCurrentIteration, mCurrentSampleCount, mLoadingTimings) : std::string{};
+}
+
+const Timeline* Runtime::getTimeline() const
+{
+    return mAcquireTimeline ? mLoadedInterface.GetTimelineFunction() : nullptr;
+}
+
 bool Runtime::setup()
 {
-    const std::string driver_filename = mManager.getPath(mTarget).generic_u8string();
+    const std::string driver_filename  = mManager.getPath(mTarget).generic_u8string();
+    const std::string shader_cache_dir = mOptions.ShaderCacheDir.generic_u8string();
 
     DriverSetupSettings settings;
-    settings.driver_filename    = driver_filename.c_str();
-    settings.database           = &mDatabase;
-    settings.framebuffer_width  = (uint32)mFilmWidth;
-    settings.framebuffer_height = (uint32)mFilmHeight;
-    settings.acquire_stats      = mAcquireStats;
-    settings.aov_count          = mTechniqueInfo.EnabledAOVs.size();
+    settings.driver_filename           = driver_filename.c_str();
+    settings.database                  = &mDatabase;
+    settings.framebuffer_width         = (uint32)mFilmWidth;
+    settings.framebuffer_height        = (uint32)mFilmHeight;
+    settings.acquire_stats             = mAcquireStats;
+    settings.acquire_timeline          = mAcquireTimeline;
+    settings.aov_count                 = mTechniqueInfo.EnabledAOVs.size();
+    settings.shader_cache_dir          = shader_cache_dir.empty() ? nullptr : shader_cache_dir.c_str();
+    settings.sort_primary_out_of_place = mOptions.SortPrimaryOutOfPlace;
+    settings.sort_primary_by_material  = mOptions.SortPrimaryByMaterial && isCPU(mTarget);
+    settings.adaptive_threshold        = mAdaptiveSampling ? mOptions.AdaptiveThreshold : 0.0f;
+    settings.adaptive_warmup           = mOptions.AdaptiveWarmup;
 
     settings.logger = &IG_LOGGER;
 
@@ -386,80 +559,97 @@ void Runtime::shutdown()
 
 bool Runtime::compileShaders()
 {
+    struct CompileJob {
+        const std::string* Source;
+        const char* Function;
+        std::string Name;
+        std::string Description;
+        void** Output;
+    };
+
     const auto startJIT = std::chrono::high_resolution_clock::now();
+
+    // Gather all shaders of all variants first. The output slots have to be stable before the parallel compilation starts
+    std::vector<CompileJob> jobs;
     mTechniqueVariantShaderSets.resize(mTechniqueVariants.size());
     for (size_t i = 0; i < mTechniqueVariants.size(); ++i) {
-        const auto& variant = mTechniqueVariants[i];
-        auto& shaders       = mTechniqueVariantShaderSets[i];
-
-        IG_LOG(L_DEBUG) << "Handling technique variant " << i << std::endl;
-        IG_LOG(L_DEBUG) << "Compiling ray generation shader" << std::endl;
-        shaders.RayGenerationShader = compileShader(variant.RayGenerationShader, "ig_ray_generation_shader", "v" + std::to_string(i) + "_rayGeneration");
-        if (shaders.RayGenerationShader == nullptr) {
-            IG_LOG(L_ERROR) << "Failed to compile ray generation shader in variant " << i << "." << std::endl;
-            return false;
-        }
-
-        IG_LOG(L_DEBUG) << "Compiling miss shader" << std::endl;
-        shaders.MissShader = compileShader(variant.MissShader, "ig_miss_shader", "v" + std::to_string(i) + "_missShader");
-        if (shaders.MissShader == nullptr) {
-            IG_LOG(L_ERROR) << "Failed to compile miss shader in variant " << i << "." << std::endl;
-            return false;
-        }
-
-        IG_LOG(L_DEBUG) << "Compiling hit shaders" << std::endl;
-        for (size_t j = 0; j < variant.HitShaders.size(); ++j) {
-            IG_LOG(L_DEBUG) << "Compiling Hit shader [" << j << "]" << std::endl;
-            shaders.HitShaders.push_back(compileShader(variant.HitShaders[j].c_str(), "ig_hit_shader", "v" + std::to_string(i) + "_hitShader" + std::to_string(j)));
-            if (shaders.HitShaders[j] == nullptr) {
-                IG_LOG(L_ERROR) << "Failed to compile hit shader " << j << " in variant " << i << "." << std::endl;
-                return false;
-            }
-        }
+        const auto& variant      = mTechniqueVariants[i];
+        auto& shaders            = mTechniqueVariantShaderSets[i];
+        const std::string prefix = "v" + std::to_string(i);
+        const std::string suffix = " in variant " + std::to_string(i);
 
-        if (!variant.AdvancedShadowHitShaders.empty()) {
-            IG_LOG(L_DEBUG) << "Compiling advanced shadow shaders" << std::endl;
+        shaders.HitShaders.resize(variant.HitShaders.size());
+        shaders.AdvancedShadowHitShaders.resize(variant.AdvancedShadowHitShaders.size());
+        shaders.AdvancedShadowMissShaders.resize(variant.AdvancedShadowMissShaders.size());
 
-            for (size_t j = 0; j < variant.AdvancedShadowHitShaders.size(); ++j) {
-                IG_LOG(L_DEBUG) << "Compiling Advanced Shadow Hit shader [" << j << "]" << std::endl;
-                shaders.AdvancedShadowHitShaders.push_back(compileShader(variant.AdvancedShadowHitShaders[j].c_str(), "ig_advanced_shadow_shader", "v" + std::to_string(i) + "_advancedShadowHit" + std::to_string(j)));
+        jobs.push_back(CompileJob{ &variant.RayGenerationShader, "ig_ray_generation_shader", prefix + "_rayGeneration", "ray generation shader" + suffix, &shaders.RayGenerationShader });
+        jobs.push_back(CompileJob{ &variant.MissShader, "ig_miss_shader", prefix + "_missShader", "miss shader" + suffix, &shaders.MissShader });
 
-                if (shaders.AdvancedShadowHitShaders[j] == nullptr) {
-                    IG_LOG(L_ERROR) << "Failed to compile advanced shadow hit shader " << j << " in variant " << i << "." << std::endl;
-                    return false;
-                }
-            }
+        for (size_t j = 0; j < variant.HitShaders.size(); ++j)
+            jobs.push_back(CompileJob{ &variant.HitShaders[j], "ig_hit_shader", prefix + "_hitShader" + std::to_string(j), "hit shader " + std::to_string(j) + suffix, &shaders.HitShaders[j] });
 
-            for (size_t j = 0; j < variant.AdvancedShadowMissShaders.size(); ++j) {
-                IG_LOG(L_DEBUG) << "Compiling Advanced Shadow Miss shader [" << j << "]" << std::endl;
-                shaders.AdvancedShadowMissShaders.push_back(compileShader(variant.AdvancedShadowMissShaders[j].c_str(), "ig_advanced_shadow_shader", "v" + std::to_string(i) + "_advancedShadowMiss" + std::to_string(j)));
+        if (!variant.AdvancedShadowHitShaders.empty()) {
+            for (size_t j = 0; j < variant.AdvancedShadowHitShaders.size(); ++j)
+                jobs.push_back(CompileJob{ &variant.AdvancedShadowHitShaders[j], "ig_advanced_shadow_shader", prefix + "_advancedShadowHit" + std::to_string(j), "advanced shadow hit shader " + std::to_string(j) + suffix, &shaders.AdvancedShadowHitShaders[j] });
 
-                if (shaders.AdvancedShadowMissShaders[j] == nullptr) {
-                    IG_LOG(L_ERROR) << "Failed to compile advanced shadow miss shader " << j << " in variant " << i << "." << std::endl;
-                    return false;
-                }
-            }
+            for (size_t j = 0; j < variant.AdvancedShadowMissShaders.size(); ++j)
+                jobs.push_back(CompileJob{ &variant.AdvancedShadowMissShaders[j], "ig_advanced_shadow_shader", prefix + "_advancedShadowMiss" + std::to_string(j), "advanced shadow miss shader " + std::to_string(j) + suffix, &shaders.AdvancedShadowMissShaders[j] });
         }
 
         for (size_t j = 0; j < variant.CallbackShaders.size(); ++j) {
-            if (variant.CallbackShaders.at(j).empty()) {
-                shaders.CallbackShaders[j] = nullptr;
-            } else {
-                IG_LOG(L_DEBUG) << "Compiling callback shader [" << i << "]" << std::endl;
-                shaders.CallbackShaders[j] = compileShader(variant.CallbackShaders.at(j), "ig_callback_shader", "v" + std::to_string(i) + "_callback" + std::to_string(j));
-                if (shaders.CallbackShaders.at(j) == nullptr) {
-                    IG_LOG(L_ERROR) << "Failed to compile callback " << j << " shader in variant " << i << "." << std::endl;
-                    return false;
-                }
-            }
+            shaders.CallbackShaders[j] = nullptr;
+            if (!variant.CallbackShaders.at(j).empty())
+                jobs.push_back(CompileJob{ &variant.CallbackShaders[j], "ig_callback_shader", prefix + "_callback" + std::to_string(j), "callback " + std::to_string(j) + " shader" + suffix, &shaders.CallbackShaders[j] });
         }
     }
-    IG_LOG(L_DEBUG) << "Compiling shaders took " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startJIT).count() / 1000.0f << " seconds" << std::endl;
 
-    return true;
+    // Identical shaders, e.g., hit shaders shared between multiple materials, are only compiled once
+    std::vector<size_t> unique_jobs;
+    std::vector<std::pair<size_t, size_t>> duplicate_jobs; // (duplicate, original)
+    std::unordered_map<std::string_view, size_t> known_sources;
+    for (size_t k = 0; k < jobs.size(); ++k) {
+        const auto it = known_sources.find(*jobs[k].Source);
+        if (it != known_sources.end() && std::string_view(jobs[it->second].Function) == jobs[k].Function) {
+            duplicate_jobs.emplace_back(k, it->second);
+        } else {
+            known_sources.emplace(*jobs[k].Source, k);
+            unique_jobs.push_back(k);
+        }
+    }
+
+    IG_LOG(L_DEBUG) << "Compiling " << unique_jobs.size() << " shaders (" << duplicate_jobs.size() << " duplicates skipped)" << std::endl;
+
+    // Compile all shaders in parallel. The driver takes care of the parts of the jit which are not thread-safe,
+    // which serializes the actual compilation unless the driver is built with IG_WITH_PARALLEL_JIT
+    std::atomic<bool> failed = false;
+    tbb::task_arena arena(mOptions.ShaderCompileThreads == 0 ? tbb::task_arena::automatic : (int)mOptions.ShaderCompileThreads);
+    arena.execute([&]() {
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, unique_jobs.size(), 1),
+            [&](const tbb::blocked_range<size_t>& range) {
+                for (size_t k = range.begin(); k < range.end(); ++k) {
+                    const auto& job = jobs[unique_jobs[k]];
+                    IG_LOG(L_DEBUG) << "Compiling " << job.Description << std::endl;
+
+                    *job.Output = compileShader(*job.Source, job.Function, job.Name);
+                    if (*job.Output == nullptr) {
+                        IG_LOG(L_ERROR) << "Failed to compile " << job.Description << "." << std::endl;
+                        failed = true;
+                    }
+                }
+            });
+    });
+
+    for (const auto& [duplicate, original] : duplicate_jobs)
+        *jobs[duplicate].Output = *jobs[original].Output;
+
+    mLoadingTimings.CompileMS = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startJIT).count();
+    IG_LOG(L_DEBUG) << "Compiling shaders took " << mLoadingTimings.CompileMS / 1000.0f << " seconds" << std::endl;
+
+    return !failed;
 }
 
-void* Runtime::compileShader(const std::string& src, const std::string& func, const std::string& name)
+void* Runtime::compileShader(const std::string& src, const std::string& func, const std::string& name) const
 {
     if (mOptions.DumpShader)
         dumpShader(name + ".art", src);
@@ -494,22 +684,56 @@ void Runtime::imageinfo(const ImageInfoSettings& settings, ImageInfoOutput& outp
 
 void Runtime::setParameter(const std::string& name, int value)
 {
-    mParameterSet.IntParameters[name] = value;
+    mParameterSet.setInt(name, value);
 }
 
 void Runtime::setParameter(const std::string& name, float value)
 {
-    mParameterSet.FloatParameters[name] = value;
+    mParameterSet.setFloat(name, value);
 }
 
 void Runtime::setParameter(const std::string& name, const Vector3f& value)
 {
-    mParameterSet.VectorParameters[name] = value;
+    mParameterSet.setVector(name, value);
 }
 
 void Runtime::setParameter(const std::string& name, const Vector4f& value)
 {
-    mParameterSet.ColorParameters[name] = value;
+    mParameterSet.setColor(name, value);
+}
+
+bool Runtime::setMaterialParameter(const std::string& name, float value)
+{
+    return setMaterialParameter(name, Vector3f::Constant(value));
+}
+
+bool Runtime::setMaterialParameter(const std::string& name, const Vector3f& value)
+{
+    const auto it = mDatabase.MaterialParameters.find(name);
+    if (it == mDatabase.MaterialParameters.end()) {
+        IG_LOG(L_ERROR) << "Unknown material parameter '" << name << "'" << std::endl;
+        return false;
+    }
+
+    auto& data = mDatabase.CustomTables.at(MaterialParameterTableName).data();
+    float* ptr = reinterpret_cast<float*>(data.data()) + it->second;
+    ptr[0]     = value.x();
+    ptr[1]     = value.y();
+    ptr[2]     = value.z();
+
+    // Make sure the change is visible to the device
+    mLoadedInterface.UpdateCustomDyntableFunction(MaterialParameterTableName);
+    return true;
+}
+
+std::vector<std::string> Runtime::getMaterialParameterNames() const
+{
+    std::vector<std::string> names;
+    names.reserve(mDatabase.MaterialParameters.size());
+    for (const auto& pair : mDatabase.MaterialParameters)
+        names.push_back(pair.first);
+    std::sort(names.begin(), names.end());
+    return names;
 }
 
 std::vector<std::string> Runtime::getAvailableTechniqueTypes()
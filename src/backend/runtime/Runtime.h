@@ -2,6 +2,7 @@
 
 #include "RuntimeStructs.h"
 #include "Statistics.h"
+#include "Timeline.h"
 #include "driver/DriverManager.h"
 #include "loader/Loader.h"
 #include "shader/ScriptPreprocessor.h"
@@ -14,24 +15,39 @@ class Scene;
 
 struct LoaderOptions;
 
+/// Fills the given buffer with at most `capacity` rays and returns the number of rays written. Returning zero ends the stream
+using RayStreamSource = std::function<size_t(Ray* rays, size_t capacity)>;
+/// Receives the accumulated radiance (3 floats per ray) of a single chunk. The data is only valid during the call
+using RayStreamSink = std::function<void(const float* data, size_t count)>;
+
 struct RuntimeOptions {
-    bool IsTracer        = false;
-    bool IsInteractive   = false;
-    bool DumpShader      = false;
-    bool DumpShaderFull  = false;
-    bool AcquireStats    = false;
-    Target DesiredTarget = Target::INVALID;
-    bool RecommendCPU    = true;
-    bool RecommendGPU    = true;
-    uint32 Device        = 0;
-    uint32 SPI           = 0; // Detect automatically
+    bool IsTracer               = false;
+    bool IsInteractive          = false;
+    bool DumpShader             = false;
+    bool DumpShaderFull         = false;
+    bool AcquireStats           = false;
+    bool AcquireTimeline        = false;
+    Target DesiredTarget        = Target::INVALID;
+    bool RecommendCPU           = true;
+    bool RecommendGPU           = true;
+    uint32 Device               = 0;
+    uint32 SPI                  = 0; // Detect automatically
+    uint32 ShaderCompileThreads = 0; // Number of threads used to compile shaders. Detect automatically. The jit is serialized without IG_WITH_PARALLEL_JIT
     std::string OverrideTechnique;
     std::string OverrideCamera;
     std::pair<uint32, uint32> OverrideFilmSize = { 0, 0 };
-
-    bool AddExtraEnvLight            = false;                           // User option to add a constant environment light (just to see something)
-    std::filesystem::path ModulePath = std::filesystem::current_path(); // Optional path to modules
-    std::filesystem::path ScriptDir  = {};                              // Path to a new script directory, replacing the internal standard library
+    std::string BVHPreset;              // Preset used to build the BVHs if not overridden by a shape. Uses 'quality' if empty
+    bool SortPrimaryOutOfPlace = false; // Sort primary rays into a second stream instead of swapping them in place. Needs more memory, CPU only
+    bool SortPrimaryByMaterial = false; // Sort primary rays by material instead of entity, resulting in fewer but larger hit shader launches. CPU only
+    float AdaptiveThreshold    = 0;     // Relative error below which a pixel is not sampled anymore. Disabled if zero. CPU only
+    uint32 AdaptiveWarmup      = 4;     // Number of iterations before a pixel is allowed to converge
+
+    bool AddExtraEnvLight                = false;                           // User option to add a constant environment light (just to see something)
+    bool UseMaterialParameterTable       = false;                           // Store constant bsdf parameters in a table instead of inlining them. Allows changes without recompiling
+    std::filesystem::path ModulePath     = std::filesystem::current_path(); // Optional path to modules
+    std::filesystem::path ScriptDir      = {};                              // Path to a new script directory, replacing the internal standard library
+    std::filesystem::path ShaderCacheDir = {};                              // Path to a directory used to cache compiled shaders between runs. Disabled if empty
+    std::filesystem::path SceneCacheDir  = {};                              // Path to a directory used to cache loaded shapes and built BVHs between runs. Disabled if empty
 };
 
 class Runtime {
@@ -49,8 +65,18 @@ public:
 
     /// Do a single iteration in non-tracing mode
     void step();
-    /// Do a single iteration in tracing mode
+    /// Do a single iteration in tracing mode. The number of rays may change between calls, which resizes the framebuffer and resets the runtime.
+    /// The result is accumulated over all iterations since the last reset
     void trace(const std::vector<Ray>& rays, std::vector<float>& data);
+    /// Same as above, but works on a plain array of rays, e.g., mapped from a file.
+    /// If normalized is true, the directions are expected to be normalized already, which allows the driver to use the rays without any conversion
+    /// The rays are uploaded on every call. If reuseRays is true, the rays uploaded by the previous call are used instead, which requires the same unchanged array.
+    /// The rays are uploaded regardless if the array or the normalization differ from the previous call
+    void trace(const Ray* rays, size_t count, std::vector<float>& data, bool normalized = false, bool reuseRays = false);
+    /// Trace an unbounded number of rays in chunks of at most chunkSize rays. The framebuffer is bound to the chunk size and reused for all chunks.
+    /// The next chunk is requested from the source on a worker thread while the current chunk is traced. The source is never called concurrently.
+    /// Each chunk is traced for the given number of iterations, after which the sink receives the accumulated result. Returns the number of rays traced
+    size_t traceStream(const RayStreamSource& source, const RayStreamSink& sink, size_t chunkSize, size_t iterations = 1, bool normalized = false);
     /// Reset internal counters etc. This should be used if data (like camera orientation) has changed. Frame counter will NOT be reset
     void reset();
 
@@ -77,8 +103,19 @@ public:
     /// Return number of samples rendered so far
     inline size_t currentSampleCount() const { return mCurrentSampleCount; }
 
+    /// Return true if adaptive sampling is used. The last AOV contains the second moment of the luminance in this case
+    inline bool isAdaptiveSampling() const { return mAdaptiveSampling; }
+    /// Return number of pixels still sampled by the adaptive sampling. Equals the number of pixels if adaptive sampling is disabled
+    size_t activePixelCount() const;
+
     /// Return pointer to structure containing statistics
     const Statistics* getStatistics() const;
+    /// Return pointer to the events recorded for each thread or nullptr if RuntimeOptions::AcquireTimeline is not set
+    const Timeline* getTimeline() const;
+    /// Return the time spent in the single phases of loading the scene
+    inline const LoadingTimings& loadingTimings() const { return mLoadingTimings; }
+    /// Return statistics as a JSON object or an empty string if RuntimeOptions::AcquireStats is not set. See Statistics::dumpAsJSON
+    std::string getStatisticsAsJSON(size_t totalMS = 0) const;
 
     /// Returns the name of the loaded technique
     inline const std::string& technique() const { return mTechniqueName; }
@@ -107,6 +144,14 @@ public:
     /// Set 4d vector parameter in the registry. Will replace already present values
     void setParameter(const std::string& name, const Vector4f& value);
 
+    /// Set number in the material parameter table. The name is given as '<bsdf>.<parameter>'.
+    /// Only available if RuntimeOptions::UseMaterialParameterTable is set. Returns false if the parameter is not available
+    bool setMaterialParameter(const std::string& name, float value);
+    /// Set color in the material parameter table. See setMaterialParameter above
+    bool setMaterialParameter(const std::string& name, const Vector3f& value);
+    /// Return all parameters available in the material parameter table
+    std::vector<std::string> getMaterialParameterNames() const;
+
     /// The current framebuffer width
     inline size_t framebufferWidth() const { return mFilmWidth; }
     /// The current framebuffer height
@@ -129,9 +174,11 @@ private:
     bool setup();
     void shutdown();
     bool compileShaders();
-    void* compileShader(const std::string& src, const std::string& func, const std::string& name);
+    void* compileShader(const std::string& src, const std::string& func, const std::string& name) const;
     void stepVariant(size_t variant);
-    void traceVariant(const std::vector<Ray>& rays, size_t variant);
+    void traceIteration(const Ray* rays, size_t count, bool normalized);
+    void traceVariant(const Ray* rays, size_t count, bool normalized, size_t variant);
+    bool checkAdaptiveSampling() const;
 
     const RuntimeOptions mOptions;
 
@@ -148,6 +195,9 @@ private:
     size_t mCurrentIteration;
     size_t mCurrentSampleCount;
     size_t mCurrentFrame;
+    size_t mCurrentRayGeneration;
+    const Ray* mTracedRays; // Array uploaded by the last call of trace()
+    bool mTracedRaysNormalized;
 
     size_t mFilmWidth;
     size_t mFilmHeight;
@@ -156,6 +206,9 @@ private:
     CameraOrientation mInitialCameraOrientation;
 
     bool mAcquireStats;
+    bool mAcquireTimeline;
+    bool mAdaptiveSampling;
+    LoadingTimings mLoadingTimings;
 
     std::string mTechniqueName;
     TechniqueInfo mTechniqueInfo;
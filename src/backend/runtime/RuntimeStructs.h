@@ -1,6 +1,6 @@
 #pragma once
 
-#include "IG_Config.h"
+#include "ParameterSet.h"
 
 namespace IG {
 struct TonemapSettings {
@@ -28,13 +28,6 @@ struct ImageInfoOutput {
     float Median;
 };
 
-struct ParameterSet {
-    std::unordered_map<std::string, int> IntParameters;
-    std::unordered_map<std::string, float> FloatParameters;
-    std::unordered_map<std::string, Vector3f> VectorParameters;
-    std::unordered_map<std::string, Vector4f> ColorParameters;
-};
-
 struct RuntimeRenderSettings {
     size_t FilmWidth  = 800;
     size_t FilmHeight = 600;
@@ -1,4 +1,5 @@
 #include "Statistics.h"
+#include <iomanip>
 #include <sstream>
 
 namespace IG {
@@ -20,13 +21,31 @@ void Statistics::beginShaderLaunch(ShaderType type, size_t workload, size_t id)
 
 void Statistics::endShaderLaunch(ShaderType type, size_t id)
 {
-    ShaderStats* stats = getStats(type, id);
-    stats->elapsedMS += stats->timer.stopMS();
+    ShaderStats* stats     = getStats(type, id);
+    const uint64 elapsedNS = stats->timer.stopNS();
+    stats->elapsedNS += elapsedNS;
+    stats->minElapsedNS = std::min(stats->minElapsedNS, elapsedNS);
+    stats->maxElapsedNS = std::max(stats->maxElapsedNS, elapsedNS);
+}
+
+void Statistics::beginSection(SectionType type)
+{
+    SectionStats& stats = mSections[(size_t)type];
+    stats.timer.start();
+    stats.count++;
+}
+
+void Statistics::endSection(SectionType type)
+{
+    SectionStats& stats = mSections[(size_t)type];
+    stats.elapsedNS += stats.timer.stopNS();
 }
 
 Statistics::ShaderStats& Statistics::ShaderStats::operator+=(const Statistics::ShaderStats& other)
 {
-    elapsedMS += other.elapsedMS;
+    elapsedNS += other.elapsedNS;
+    minElapsedNS = std::min(minElapsedNS, other.minElapsedNS);
+    maxElapsedNS = std::max(maxElapsedNS, other.maxElapsedNS);
     count += other.count;
     workload += other.workload;
     max_workload = std::max(max_workload, other.max_workload);
@@ -35,6 +54,14 @@ Statistics::ShaderStats& Statistics::ShaderStats::operator+=(const Statistics::S
     return *this;
 }
 
+Statistics::SectionStats& Statistics::SectionStats::operator+=(const Statistics::SectionStats& other)
+{
+    elapsedNS += other.elapsedNS;
+    count += other.count;
+
+    return *this;
+}
+
 void Statistics::add(const Statistics& other)
 {
     mDeviceStats += other.mDeviceStats;
@@ -53,6 +80,12 @@ void Statistics::add(const Statistics& other)
 
     for (size_t i = 0; i < other.mQuantities.size(); ++i)
         mQuantities[i] += other.mQuantities[i];
+
+    for (size_t i = 0; i < other.mSections.size(); ++i)
+        mSections[i] += other.mSections[i];
+
+    mShaderCacheMarkersFound += other.mShaderCacheMarkersFound;
+    mShaderCacheMarkersMissing += other.mShaderCacheMarkersMissing;
 }
 
 class DumpTable {
@@ -124,18 +157,19 @@ private:
 std::string Statistics::dump(size_t totalMS, size_t iter, bool verbose) const
 {
     DumpTable table;
-    const auto dumpInline = [&](const std::string& name, size_t count, size_t elapsedMS, float percentage = -1, size_t max_workload = 0, size_t min_workload = 0) {
+    const auto dumpInline = [&](const std::string& name, size_t count, uint64 elapsedNS, float percentage = -1, size_t max_workload = 0, size_t min_workload = 0) {
         std::vector<std::string> cols;
         cols.emplace_back(name);
 
+        const double elapsedMS = elapsedNS / 1e6;
         {
             std::stringstream bstream;
-            bstream << elapsedMS << "ms [" << count << "]";
+            bstream << std::fixed << std::setprecision(3) << elapsedMS << "ms [" << count << "]";
             cols.emplace_back(bstream.str());
         }
         if (iter != 0) {
             std::stringstream bstream;
-            bstream << elapsedMS / iter << "ms [" << count / iter << "] per Iteration";
+            bstream << std::fixed << std::setprecision(3) << elapsedMS / iter << "ms [" << count / iter << "] per Iteration";
             cols.emplace_back(bstream.str());
         }
         if (percentage >= 0) {
@@ -154,11 +188,11 @@ std::string Statistics::dump(size_t totalMS, size_t iter, bool verbose) const
     };
 
     const auto dumpStats = [&](const std::string& name, const ShaderStats& stats) {
-        return dumpInline(name, stats.count, stats.elapsedMS);
+        return dumpInline(name, stats.count, stats.elapsedNS);
     };
 
     const auto dumpStatsDetail = [&](const std::string& name, const ShaderStats& stats, size_t total_workload) {
-        return dumpInline(name, stats.count, stats.elapsedMS, static_cast<float>(double(stats.workload) / double(total_workload)), stats.max_workload, stats.min_workload);
+        return dumpInline(name, stats.count, stats.elapsedNS, static_cast<float>(double(stats.workload) / double(total_workload)), stats.max_workload, stats.min_workload);
     };
 
     const auto dumpQuantity = [=](size_t count) {
@@ -221,6 +255,28 @@ std::string Statistics::dump(size_t totalMS, size_t iter, bool verbose) const
     if (mTonemapStats.count > 0)
         dumpStats("  |-Tonemap", mTonemapStats);
 
+    // Sections are summed over all threads, therefore they might exceed the total render time
+    bool hasSections = false;
+    for (const auto& section : mSections)
+        hasSections = hasSections || section.count > 0;
+
+    if (hasSections) {
+        const auto dumpSection = [&](const std::string& name, SectionType type) {
+            const SectionStats& stats = mSections[(size_t)type];
+            return dumpInline(name, stats.count, stats.elapsedNS);
+        };
+
+        table.addRow({ "  Sections:" });
+        dumpSection("  |-TraversalPrimary", SectionType::TraversalPrimary);
+        dumpSection("  |-TraversalSecondary", SectionType::TraversalSecondary);
+        dumpSection("  |-SortPrimary", SectionType::SortPrimary);
+        dumpSection("  |-SortSecondary", SectionType::SortSecondary);
+        dumpSection("  |-CompactPrimary", SectionType::CompactPrimary);
+        dumpSection("  |-CompactSecondary", SectionType::CompactSecondary);
+        dumpSection("  |-Shading", SectionType::Shading);
+        dumpSection("  |-SecondaryShading", SectionType::SecondaryShading);
+    }
+
     table.addRow({ "  Quantities:" });
     table.addRow({ "  |-CameraRays", dumpQuantity(mQuantities[(size_t)Quantity::CameraRayCount]) });
     table.addRow({ "  |-ShadowRays", dumpQuantity(mQuantities[(size_t)Quantity::ShadowRayCount]) });
@@ -228,9 +284,186 @@ std::string Statistics::dump(size_t totalMS, size_t iter, bool verbose) const
     table.addRow({ "  |-PrimaryRays", dumpQuantity(mQuantities[(size_t)Quantity::CameraRayCount] + mQuantities[(size_t)Quantity::BounceRayCount]) });
     table.addRow({ "  |-TotalRays", dumpQuantity(mQuantities[(size_t)Quantity::CameraRayCount] + mQuantities[(size_t)Quantity::BounceRayCount] + mQuantities[(size_t)Quantity::ShadowRayCount]) });
 
+    if (mShaderCacheMarkersFound + mShaderCacheMarkersMissing > 0) {
+        table.addRow({ "  ShaderCache:" });
+        table.addRow({ "  |-MarkersFound", std::to_string(mShaderCacheMarkersFound) });
+        table.addRow({ "  |-MarkersMissing", std::to_string(mShaderCacheMarkersMissing) });
+    }
+
     return table.print(false, true);
 }
 
+// Minimal writer for the JSON output. Only numbers and fixed keys are written, therefore no escaping is required
+class JSONWriter {
+public:
+    explicit JSONWriter(std::ostream& stream)
+        : mStream(stream)
+        , mFirst(true)
+    {
+    }
+
+    void beginObject(const char* key = nullptr)
+    {
+        prefix(key);
+        mStream << "{";
+        mFirst = true;
+    }
+
+    void endObject()
+    {
+        mStream << "}";
+        mFirst = false;
+    }
+
+    void beginArray(const char* key)
+    {
+        prefix(key);
+        mStream << "[";
+        mFirst = true;
+    }
+
+    void endArray()
+    {
+        mStream << "]";
+        mFirst = false;
+    }
+
+    template <typename T>
+    void value(const char* key, T value)
+    {
+        prefix(key);
+        mStream << value;
+    }
+
+private:
+    void prefix(const char* key)
+    {
+        if (!mFirst)
+            mStream << ",";
+        mFirst = false;
+
+        if (key)
+            mStream << "\"" << key << "\":";
+    }
+
+    std::ostream& mStream;
+    bool mFirst;
+};
+
+std::string Statistics::dumpAsJSON(size_t totalMS, size_t iter, size_t samples, const LoadingTimings& loading) const
+{
+    std::stringstream stream;
+    stream << std::fixed << std::setprecision(6);
+
+    const double totalSec = totalMS > 0 ? totalMS / 1e3 : mDeviceStats.elapsedNS / 1e9;
+    const auto perSec     = [=](double value) { return totalSec > 0 ? value / totalSec : 0.0; };
+
+    const auto writeStats = [](JSONWriter& writer, const ShaderStats& stats) {
+        const double elapsedSec = stats.elapsedNS / 1e9;
+        writer.value("count", stats.count);
+        writer.value("elapsed_ms", stats.elapsedNS / 1e6);
+        writer.value("min_ms", stats.count > 0 ? stats.minElapsedNS / 1e6 : 0.0);
+        writer.value("max_ms", stats.maxElapsedNS / 1e6);
+        writer.value("workload", stats.workload);
+        writer.value("min_workload", stats.count > 0 ? stats.min_workload : 0);
+        writer.value("max_workload", stats.max_workload);
+        writer.value("workload_per_second", elapsedSec > 0 ? stats.workload / elapsedSec : 0.0);
+    };
+
+    const auto writeSingle = [&](JSONWriter& writer, const char* key, const ShaderStats& stats) {
+        if (stats.count == 0)
+            return;
+        writer.beginObject(key);
+        writeStats(writer, stats);
+        writer.endObject();
+    };
+
+    const auto writeMap = [&](JSONWriter& writer, const char* key, const char* idKey, const std::map<size_t, ShaderStats>& map) {
+        writer.beginArray(key);
+        for (const auto& pair : map) {
+            writer.beginObject();
+            writer.value(idKey, pair.first);
+            writeStats(writer, pair.second);
+            writer.endObject();
+        }
+        writer.endArray();
+    };
+
+    const uint64 cameraRays = mQuantities[(size_t)Quantity::CameraRayCount];
+    const uint64 shadowRays = mQuantities[(size_t)Quantity::ShadowRayCount];
+    const uint64 bounceRays = mQuantities[(size_t)Quantity::BounceRayCount];
+    const uint64 totalRays  = cameraRays + shadowRays + bounceRays;
+
+    JSONWriter writer(stream);
+    writer.beginObject();
+    writer.value("iterations", iter);
+    writer.value("samples", samples);
+    writer.value("total_ms", totalSec * 1e3);
+
+    writer.beginObject("throughput");
+    writer.value("rays_per_second", perSec((double)totalRays));
+    writer.value("samples_per_second", perSec((double)samples));
+    writer.value("iterations_per_second", perSec((double)iter));
+    writer.endObject();
+
+    // Every iteration is a single device launch
+    writer.beginObject("iteration");
+    writer.value("mean_ms", mDeviceStats.count > 0 ? mDeviceStats.elapsedNS / 1e6 / mDeviceStats.count : 0.0);
+    writer.value("min_ms", mDeviceStats.count > 0 ? mDeviceStats.minElapsedNS / 1e6 : 0.0);
+    writer.value("max_ms", mDeviceStats.maxElapsedNS / 1e6);
+    writer.endObject();
+
+    writer.beginObject("loading");
+    writer.value("parse_ms", loading.ParseMS);
+    writer.value("shape_load_ms", loading.ShapeLoadMS);
+    writer.value("bvh_build_ms", loading.BVHBuildMS);
+    writer.value("table_store_ms", loading.TableStoreMS);
+    writer.value("loader_ms", loading.LoaderMS);
+    writer.value("compile_ms", loading.CompileMS);
+    writer.endObject();
+
+    writer.beginObject("quantities");
+    writer.value("camera_rays", cameraRays);
+    writer.value("shadow_rays", shadowRays);
+    writer.value("bounce_rays", bounceRays);
+    writer.value("primary_rays", cameraRays + bounceRays);
+    writer.value("total_rays", totalRays);
+    writer.endObject();
+
+    writer.beginObject("shaders");
+    writeSingle(writer, "device", mDeviceStats);
+    writeSingle(writer, "ray_generation", mRayGenerationStats);
+    writeSingle(writer, "miss", mMissStats);
+    writeMap(writer, "hit", "material", mHitStats);
+    writeMap(writer, "advanced_shadow_hit", "material", mAdvancedShadowHitStats);
+    writeMap(writer, "advanced_shadow_miss", "material", mAdvancedShadowMissStats);
+    writeMap(writer, "callback", "type", mCallbackStats);
+    writeSingle(writer, "image_info", mImageInfoStats);
+    writeSingle(writer, "tonemap", mTonemapStats);
+    writer.endObject();
+
+    // Sections are summed over all threads, therefore they might exceed the total render time
+    static const char* SectionNames[] = { "traversal_primary", "traversal_secondary", "sort_primary", "sort_secondary", "compact_primary", "compact_secondary", "shading", "secondary_shading" };
+    static_assert(sizeof(SectionNames) / sizeof(SectionNames[0]) == (size_t)SectionType::_COUNT, "Expected all sections to be named");
+
+    writer.beginObject("sections");
+    for (size_t i = 0; i < mSections.size(); ++i) {
+        writer.beginObject(SectionNames[i]);
+        writer.value("count", mSections[i].count);
+        writer.value("elapsed_ms", mSections[i].elapsedNS / 1e6);
+        writer.endObject();
+    }
+    writer.endObject();
+
+    writer.beginObject("shader_cache");
+    writer.value("markers_found", mShaderCacheMarkersFound);
+    writer.value("markers_missing", mShaderCacheMarkersMissing);
+    writer.endObject();
+
+    writer.endObject();
+    return stream.str();
+}
+
 Statistics::ShaderStats* Statistics::getStats(ShaderType type, size_t id)
 {
     switch (type) {
@@ -248,7 +481,7 @@ Statistics::ShaderStats* Statistics::getStats(ShaderType type, size_t id)
     case ShaderType::AdvancedShadowMiss:
         return &mAdvancedShadowMissStats[id];
     case ShaderType::Callback:
-        return &mHitStats[id];
+        return &mCallbackStats[id];
     case ShaderType::Tonemap:
         return &mTonemapStats;
     case ShaderType::ImageInfo:
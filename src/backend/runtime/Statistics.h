@@ -27,6 +27,30 @@ enum class Quantity {
     _COUNT
 };
 
+enum class SectionType {
+    // This should be in sync with core/stats.art
+    TraversalPrimary = 0,
+    TraversalSecondary,
+    SortPrimary,
+    SortSecondary,
+    CompactPrimary,
+    CompactSecondary,
+    Shading,
+    SecondaryShading,
+
+    _COUNT
+};
+
+/// Wall clock timings of the phases of loading a scene, in milliseconds
+struct LoadingTimings {
+    size_t ParseMS      = 0;
+    size_t ShapeLoadMS  = 0; // Part of LoaderMS
+    size_t BVHBuildMS   = 0; // Part of LoaderMS
+    size_t TableStoreMS = 0; // Storing shapes and BVHs into the tables. Part of ShapeLoadMS and BVHBuildMS
+    size_t LoaderMS     = 0; // Whole loader including shapes, BVHs and shader generation
+    size_t CompileMS    = 0; // Just-in-time compilation of all shaders
+};
+
 class Statistics {
 public:
     Statistics();
@@ -39,19 +63,39 @@ public:
     void beginShaderLaunch(ShaderType type, size_t workload, size_t id);
     void endShaderLaunch(ShaderType type, size_t id);
 
+    void beginSection(SectionType type);
+    void endSection(SectionType type);
+
     inline void increase(Quantity quantity, uint64 value)
     {
         mQuantities[(size_t)quantity] += value;
     }
 
+    inline uint64 quantity(Quantity quantity) const
+    {
+        return mQuantities[(size_t)quantity];
+    }
+
+    /// Number of shaders with a found or missing marker of the persistent shader cache, see ShaderCache.
+    /// This is not the number of modules actually loaded from the AnyDSL cache
+    inline void addShaderCacheMarkers(size_t found, size_t missing)
+    {
+        mShaderCacheMarkersFound += found;
+        mShaderCacheMarkersMissing += missing;
+    }
+
     void add(const Statistics& other);
 
     [[nodiscard]] std::string dump(size_t totalMS, size_t iter, bool verbose) const;
+    /// Same content as dump, but as a JSON object including derived throughput numbers. If totalMS is zero, the time spent in the device is used instead
+    [[nodiscard]] std::string dumpAsJSON(size_t totalMS, size_t iter, size_t samples, const LoadingTimings& loading) const;
 
 private:
     struct ShaderStats {
         Timer timer;
-        size_t elapsedMS    = 0;
+        uint64 elapsedNS    = 0;
+        uint64 minElapsedNS = std::numeric_limits<uint64>::max();
+        uint64 maxElapsedNS = 0;
         size_t count        = 0;
         size_t workload     = 0; // This might overflow, but who cares for statistical stuff after that huge number of iterations
         size_t max_workload = 0;
@@ -60,6 +104,14 @@ private:
         ShaderStats& operator+=(const ShaderStats& other);
     };
 
+    struct SectionStats {
+        Timer timer;
+        uint64 elapsedNS = 0;
+        size_t count     = 0;
+
+        SectionStats& operator+=(const SectionStats& other);
+    };
+
     [[nodiscard]] ShaderStats* getStats(ShaderType type, size_t id);
 
     ShaderStats mDeviceStats;
@@ -73,5 +125,9 @@ private:
     ShaderStats mTonemapStats;
 
     std::array<uint64, (size_t)Quantity::_COUNT> mQuantities;
+    std::array<SectionStats, (size_t)SectionType::_COUNT> mSections;
+
+    size_t mShaderCacheMarkersFound   = 0;
+    size_t mShaderCacheMarkersMissing = 0;
 };
 } // namespace IG
\ No newline at end of file
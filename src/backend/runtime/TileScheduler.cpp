@@ -0,0 +1,180 @@
+#include "TileScheduler.h"
+
+#include <algorithm>
+
+namespace IG {
+static inline int32 divUp(int32 a, int32 b) { return (a + b - 1) / b; }
+
+TileScheduler::TileScheduler()
+    : mWidth(0)
+    , mHeight(0)
+    , mTileSize(0)
+    , mGridWidth(0)
+    , mGridHeight(0)
+    , mNext(0)
+{
+}
+
+int32 TileScheduler::computeTileSize(int32 width, int32 height, int32 maxTileSize, size_t threadCount)
+{
+    const size_t minTiles = TilesPerThread * std::max<size_t>(1, threadCount);
+
+    int32 size = std::max(maxTileSize, MinTileSize);
+    while (size > MinTileSize && (size_t)divUp(width, size) * (size_t)divUp(height, size) < minTiles)
+        size /= 2;
+    return std::max(size, MinTileSize);
+}
+
+size_t TileScheduler::prepare(int32 width, int32 height, int32 maxTileSize, size_t threadCount)
+{
+    if (width != mWidth || height != mHeight) {
+        mWidth      = width;
+        mHeight     = height;
+        mGridWidth  = divUp(width, MinTileSize);
+        mGridHeight = divUp(height, MinTileSize);
+        mCosts.assign((size_t)mGridWidth * mGridHeight, -1.0f);
+    } else {
+        updateCosts();
+    }
+
+    mTileSize = computeTileSize(width, height, maxTileSize, threadCount);
+
+    std::vector<std::pair<float, TileRegion>> tiles;
+    tiles.reserve((size_t)divUp(width, mTileSize) * divUp(height, mTileSize));
+
+    size_t knownCount = 0;
+    float knownCost   = 0;
+    for (int32 y = 0; y < height; y += mTileSize) {
+        for (int32 x = 0; x < width; x += mTileSize) {
+            const TileRegion region{ x, y, std::min(x + mTileSize, width), std::min(y + mTileSize, height) };
+            const float cost = estimateCost(region);
+            if (cost >= 0) {
+                ++knownCount;
+                knownCost += cost;
+            }
+            tiles.emplace_back(cost, region);
+        }
+    }
+
+    // Without any timings the tiles are handed out in scanline order
+    if (knownCount > 0) {
+        // Tiles without a timing (e.g., due to a changed film) are assumed to be average
+        const float average = knownCost / knownCount;
+        for (auto& tile : tiles) {
+            if (tile.first < 0)
+                tile.first = average;
+        }
+
+        std::vector<std::pair<float, TileRegion>> splitTiles;
+        splitTiles.reserve(tiles.size());
+        for (const auto& tile : tiles)
+            splitTile(tile.second, tile.first, SplitFactor * average, splitTiles);
+        tiles.swap(splitTiles);
+
+        std::stable_sort(tiles.begin(), tiles.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    }
+
+    mTiles.resize(tiles.size());
+    for (size_t i = 0; i < tiles.size(); ++i)
+        mTiles[i] = tiles[i].second;
+
+    mTileTimes.assign(mTiles.size(), 0);
+    mNext.store(0, std::memory_order_release);
+
+    return mTiles.size();
+}
+
+void TileScheduler::splitTile(const TileRegion& region, float cost, float threshold, std::vector<std::pair<float, TileRegion>>& tiles) const
+{
+    const bool splitX = region.width() >= 2 * MinTileSize;
+    const bool splitY = region.height() >= 2 * MinTileSize;
+    if (cost <= threshold || (!splitX && !splitY)) {
+        tiles.emplace_back(cost, region);
+        return;
+    }
+
+    // Keep the split aligned to the cost grid
+    const int32 midX = splitX ? region.XMin + std::max(MinTileSize, (region.width() / 2) / MinTileSize * MinTileSize) : region.XMax;
+    const int32 midY = splitY ? region.YMin + std::max(MinTileSize, (region.height() / 2) / MinTileSize * MinTileSize) : region.YMax;
+
+    const TileRegion parts[4] = {
+        { region.XMin, region.YMin, midX, midY },
+        { midX, region.YMin, region.XMax, midY },
+        { region.XMin, midY, midX, region.YMax },
+        { midX, midY, region.XMax, region.YMax }
+    };
+
+    for (const auto& part : parts) {
+        if (part.width() <= 0 || part.height() <= 0)
+            continue;
+
+        const float partCost = estimateCost(part);
+        splitTile(part, partCost < 0 ? cost * part.width() * part.height() / (region.width() * region.height()) : partCost, threshold, tiles);
+    }
+}
+
+float TileScheduler::estimateCost(const TileRegion& region) const
+{
+    if (mCosts.empty())
+        return -1;
+
+    float cost = 0;
+    for (int32 gy = region.YMin / MinTileSize; gy < divUp(region.YMax, MinTileSize); ++gy) {
+        for (int32 gx = region.XMin / MinTileSize; gx < divUp(region.XMax, MinTileSize); ++gx) {
+            const float cell = mCosts[(size_t)gy * mGridWidth + gx];
+            if (cell < 0)
+                return -1;
+            cost += cell;
+        }
+    }
+
+    return cost;
+}
+
+bool TileScheduler::acquire(TileRegion& region, uint32& id)
+{
+    const size_t next = mNext.fetch_add(1, std::memory_order_relaxed);
+    if (next >= mTiles.size())
+        return false;
+
+    region = mTiles[next];
+    id     = (uint32)next;
+    return true;
+}
+
+void TileScheduler::release(uint32 id, uint64 elapsedNS)
+{
+    IG_ASSERT(id < mTileTimes.size(), "Invalid tile id");
+    mTileTimes[id] = std::max<uint64>(1, elapsedNS); // Zero is reserved for tiles without timing
+}
+
+void TileScheduler::updateCosts()
+{
+    // The time of a tile is distributed over the covered cells proportional to their area
+    for (size_t i = 0; i < mTiles.size(); ++i) {
+        if (mTileTimes[i] == 0)
+            continue;
+
+        const TileRegion& region = mTiles[i];
+        const float timePerPixel = mTileTimes[i] / (float)(region.width() * region.height());
+        for (int32 gy = region.YMin / MinTileSize; gy < divUp(region.YMax, MinTileSize); ++gy) {
+            const int32 cellHeight = std::min((gy + 1) * MinTileSize, region.YMax) - std::max(gy * MinTileSize, region.YMin);
+            for (int32 gx = region.XMin / MinTileSize; gx < divUp(region.XMax, MinTileSize); ++gx) {
+                const int32 cellWidth = std::min((gx + 1) * MinTileSize, region.XMax) - std::max(gx * MinTileSize, region.XMin);
+                const float measured  = timePerPixel * cellWidth * cellHeight;
+
+                float& cost = mCosts[(size_t)gy * mGridWidth + gx];
+                cost        = cost < 0 ? measured : (1 - CostSmoothing) * cost + CostSmoothing * measured;
+            }
+        }
+    }
+
+    std::fill(mTileTimes.begin(), mTileTimes.end(), 0);
+}
+
+void TileScheduler::reset()
+{
+    std::fill(mCosts.begin(), mCosts.end(), -1.0f);
+    std::fill(mTileTimes.begin(), mTileTimes.end(), 0);
+}
+} // namespace IG
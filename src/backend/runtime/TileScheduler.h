@@ -0,0 +1,72 @@
+#pragma once
+
+#include "IG_Config.h"
+
+#include <atomic>
+
+namespace IG {
+/// Area of the film handled by a single work package. Max coordinates are exclusive
+struct TileRegion {
+    int32 XMin;
+    int32 YMin;
+    int32 XMax;
+    int32 YMax;
+
+    inline int32 width() const { return XMax - XMin; }
+    inline int32 height() const { return YMax - YMin; }
+};
+
+/// Distributes the film as tiles to the worker threads of an iteration.
+/// The tile size depends on the film size and the number of threads. The time spent on each tile is tracked on a coarse grid,
+/// such that the tiles of the next iteration can be handed out by estimated cost, most expensive first. Tiles much more expensive than the average are split.
+/// Threads pull tiles from a shared counter, therefore a thread running out of work steals the remaining tiles of all others
+class TileScheduler {
+public:
+    static constexpr int32 MinTileSize     = 8;    // Also the resolution of the cost grid
+    static constexpr size_t TilesPerThread = 8;    // Minimum number of tiles per thread before the tile size is reduced
+    static constexpr float SplitFactor     = 4.0f; // Tiles estimated to be more expensive than the average by this factor are split
+    static constexpr float CostSmoothing   = 0.5f; // Weight of the newest timing in the cost estimate
+
+    TileScheduler();
+
+    /// Prepare the tiles for the next iteration. Timings of the previous iteration are incorporated into the cost estimate.
+    /// Not thread safe, has to be called before any tile is acquired
+    size_t prepare(int32 width, int32 height, int32 maxTileSize, size_t threadCount);
+
+    /// Get the next tile to work on. Thread safe. Returns false if all tiles are handed out
+    bool acquire(TileRegion& region, uint32& id);
+
+    /// Report the time spent on the given tile. Thread safe, as long as each tile is reported only once
+    void release(uint32 id, uint64 elapsedNS);
+
+    /// Tile size used for a film with the given size, such that each thread gets enough tiles
+    static int32 computeTileSize(int32 width, int32 height, int32 maxTileSize, size_t threadCount);
+
+    inline size_t tileCount() const { return mTiles.size(); }
+    inline const TileRegion& tile(size_t id) const { return mTiles[id]; }
+    inline int32 tileSize() const { return mTileSize; }
+
+    /// Estimated cost in nanoseconds of the given region, based on all previous iterations
+    float estimateCost(const TileRegion& region) const;
+
+    /// Forget all measured costs
+    void reset();
+
+private:
+    void updateCosts();
+    void splitTile(const TileRegion& region, float cost, float threshold, std::vector<std::pair<float, TileRegion>>& tiles) const;
+
+    int32 mWidth;
+    int32 mHeight;
+    int32 mTileSize;
+
+    // Estimated cost per cell of MinTileSize x MinTileSize pixels. Negative if unknown
+    int32 mGridWidth;
+    int32 mGridHeight;
+    std::vector<float> mCosts;
+
+    std::vector<TileRegion> mTiles;
+    std::vector<uint64> mTileTimes; // Zero if not reported
+    std::atomic<size_t> mNext;
+};
+} // namespace IG
@@ -0,0 +1,153 @@
+#include "Timeline.h"
+#include "Logger.h"
+
+#include <fstream>
+#include <iomanip>
+
+namespace IG {
+TimelineRecorder::TimelineRecorder()
+    : mEvents()
+    , mHead(0)
+    , mStack()
+    , mDepth(0)
+{
+}
+
+void TimelineRecorder::setCapacity(size_t capacity)
+{
+    mEvents.resize(capacity);
+    clear();
+}
+
+void TimelineRecorder::snapshot(std::vector<TimelineEvent>& events) const
+{
+    if (mEvents.empty())
+        return;
+
+    const size_t head  = mHead.load(std::memory_order_acquire);
+    const size_t count = std::min(head, mEvents.size());
+    events.reserve(events.size() + count);
+    for (size_t i = head - count; i < head; ++i)
+        events.push_back(mEvents[i % mEvents.size()]);
+}
+
+void TimelineRecorder::clear()
+{
+    mHead.store(0, std::memory_order_release);
+    mDepth = 0;
+}
+
+uint64 TimelineRecorder::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static const char* getEventName(const TimelineEvent& event)
+{
+    switch (event.Category) {
+    case TimelineCategory::Tile:
+        return "Tile";
+    case TimelineCategory::Shader:
+        switch ((ShaderType)event.Type) {
+        case ShaderType::Device:
+            return "Device";
+        case ShaderType::RayGeneration:
+            return "RayGeneration";
+        case ShaderType::Hit:
+            return "Hit";
+        case ShaderType::Miss:
+            return "Miss";
+        case ShaderType::AdvancedShadowHit:
+            return "AdvancedShadowHit";
+        case ShaderType::AdvancedShadowMiss:
+            return "AdvancedShadowMiss";
+        case ShaderType::Callback:
+            return "Callback";
+        case ShaderType::Tonemap:
+            return "Tonemap";
+        case ShaderType::ImageInfo:
+            return "ImageInfo";
+        }
+        break;
+    case TimelineCategory::Section:
+        switch ((SectionType)event.Type) {
+        case SectionType::TraversalPrimary:
+            return "TraversalPrimary";
+        case SectionType::TraversalSecondary:
+            return "TraversalSecondary";
+        case SectionType::SortPrimary:
+            return "SortPrimary";
+        case SectionType::SortSecondary:
+            return "SortSecondary";
+        case SectionType::CompactPrimary:
+            return "CompactPrimary";
+        case SectionType::CompactSecondary:
+            return "CompactSecondary";
+        case SectionType::Shading:
+            return "Shading";
+        case SectionType::SecondaryShading:
+            return "SecondaryShading";
+        default:
+            break;
+        }
+        break;
+    }
+    return "Unknown";
+}
+
+static const char* getCategoryName(TimelineCategory category)
+{
+    switch (category) {
+    case TimelineCategory::Tile:
+        return "tile";
+    case TimelineCategory::Shader:
+        return "shader";
+    case TimelineCategory::Section:
+        return "section";
+    }
+    return "unknown";
+}
+
+bool Timeline::writeChromeTrace(const std::filesystem::path& path) const
+{
+    std::ofstream stream(path);
+    if (!stream) {
+        IG_LOG(L_ERROR) << "Could not open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    // Timestamps are given relative to the first event, as the epoch of the steady clock is arbitrary
+    uint64 start = std::numeric_limits<uint64>::max();
+    for (const auto& lane : mLanes) {
+        for (const auto& event : lane)
+            start = std::min(start, event.BeginNS);
+    }
+
+    stream << std::fixed << std::setprecision(3);
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    for (size_t tid = 0; tid < mLanes.size(); ++tid) {
+        if (mLanes[tid].empty())
+            continue;
+
+        stream << (first ? "" : ",") << std::endl
+               << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << tid << ",\"args\":{\"name\":\"Thread " << tid << "\"}}";
+        first = false;
+
+        for (const auto& event : mLanes[tid]) {
+            // Chrome traces expect microseconds
+            stream << "," << std::endl
+                   << "{\"name\":\"" << getEventName(event) << "\",\"cat\":\"" << getCategoryName(event.Category) << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << tid
+                   << ",\"ts\":" << (event.BeginNS - start) / 1000.0 << ",\"dur\":" << (event.EndNS - event.BeginNS) / 1000.0;
+            if (event.ID >= 0)
+                stream << ",\"args\":{\"id\":" << event.ID << "}";
+            stream << "}";
+        }
+    }
+
+    stream << std::endl
+           << "]}" << std::endl;
+    return true;
+}
+} // namespace IG
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Statistics.h"
+
+#include <atomic>
+#include <filesystem>
+#include <vector>
+
+namespace IG {
+enum class TimelineCategory : uint32 {
+    Tile = 0, // Work package of a single thread
+    Shader,   // Type is given by ShaderType. The device launch spans a whole iteration
+    Section   // Type is given by SectionType
+};
+
+/// A single completed span of work. Timestamps are nanoseconds of the steady clock
+struct TimelineEvent {
+    uint64 BeginNS;
+    uint64 EndNS;
+    TimelineCategory Category;
+    uint32 Type;
+    int32 ID; // Material or callback id if available, else -1
+};
+
+/// Records the events of a single thread into a fixed-size ring buffer. If the buffer is full, the oldest events are overwritten.
+/// Only the owning thread is allowed to write, therefore no locks are required
+class TimelineRecorder {
+public:
+    static constexpr size_t DefaultCapacity = 1 << 16;
+    static constexpr size_t MaxDepth        = 16;
+
+    /// Recorder without any storage. Events are ignored until setCapacity is called
+    TimelineRecorder();
+
+    void setCapacity(size_t capacity);
+    inline size_t capacity() const { return mEvents.size(); }
+
+    inline void begin()
+    {
+        if (mDepth < MaxDepth)
+            mStack[mDepth] = now();
+        ++mDepth;
+    }
+
+    inline void end(TimelineCategory category, uint32 type, int32 id = -1)
+    {
+        IG_ASSERT(mDepth > 0, "Unbalanced timeline event");
+        --mDepth;
+        if (mDepth >= MaxDepth || mEvents.empty())
+            return;
+
+        const size_t head              = mHead.load(std::memory_order_relaxed);
+        mEvents[head % mEvents.size()] = TimelineEvent{ mStack[mDepth], now(), category, type, id };
+        mHead.store(head + 1, std::memory_order_release);
+    }
+
+    /// Append all events still in the buffer in the order they were completed
+    void snapshot(std::vector<TimelineEvent>& events) const;
+
+    /// Number of events lost due to the ring buffer being full
+    inline size_t droppedCount() const
+    {
+        const size_t head = mHead.load(std::memory_order_acquire);
+        return head > mEvents.size() ? head - mEvents.size() : 0;
+    }
+
+    void clear();
+
+    static uint64 now();
+
+private:
+    std::vector<TimelineEvent> mEvents;
+    std::atomic<size_t> mHead; // Total number of events written so far
+    std::array<uint64, MaxDepth> mStack;
+    size_t mDepth;
+};
+
+/// Events of all threads gathered from the driver, one lane per thread
+class Timeline {
+public:
+    inline void clear() { mLanes.clear(); }
+    inline std::vector<TimelineEvent>& addLane() { return mLanes.emplace_back(); }
+    inline const std::vector<std::vector<TimelineEvent>>& lanes() const { return mLanes; }
+
+    /// Write all events in the Chrome trace event format, which can be opened with chrome://tracing or Perfetto
+    bool writeChromeTrace(const std::filesystem::path& path) const;
+
+private:
+    std::vector<std::vector<TimelineEvent>> mLanes;
+};
+} // namespace IG
@@ -81,6 +81,16 @@ public:
         return std::chrono::duration_cast<std::chrono::milliseconds>(stop()).count();
     }
 
+    /**
+     * @brief Same as stop(), but will return duration in nanoseconds
+     * 
+     * @return Duration in nanoseconds 
+     */
+    inline uint64 stopNS()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(stop()).count();
+    }
+
     /**
      * @brief Same as peek(), but will return duration in milliseconds
      * 
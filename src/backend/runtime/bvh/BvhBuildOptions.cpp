@@ -0,0 +1,75 @@
+#include "BvhBuildOptions.h"
+
+namespace IG {
+BvhBuildOptions BvhBuildOptions::makeFast()
+{
+    return BvhBuildOptions{ BvhBuilderType::PLOC, false, true };
+}
+
+BvhBuildOptions BvhBuildOptions::makeBalanced()
+{
+    return BvhBuildOptions{ BvhBuilderType::BinnedSAH, false, true };
+}
+
+BvhBuildOptions BvhBuildOptions::makeQuality()
+{
+    return BvhBuildOptions{ BvhBuilderType::SpatialSplit, true, true };
+}
+
+std::optional<BvhBuildOptions> BvhBuildOptions::fromPreset(const std::string& name)
+{
+    const std::string preset = to_lowercase(name);
+    if (preset == "fast")
+        return makeFast();
+    else if (preset == "balanced")
+        return makeBalanced();
+    else if (preset == "quality")
+        return makeQuality();
+    else
+        return std::nullopt;
+}
+
+std::vector<std::string> BvhBuildOptions::getAvailablePresets()
+{
+    return { "fast", "balanced", "quality" };
+}
+
+std::optional<BvhBuilderType> BvhBuildOptions::getBuilderFromString(const std::string& name)
+{
+    const std::string builder = to_lowercase(name);
+    if (builder == "sweep" || builder == "sweep_sah")
+        return BvhBuilderType::SweepSAH;
+    else if (builder == "binned" || builder == "binned_sah")
+        return BvhBuilderType::BinnedSAH;
+    else if (builder == "lbvh")
+        return BvhBuilderType::LBVH;
+    else if (builder == "ploc")
+        return BvhBuilderType::PLOC;
+    else if (builder == "spatial_split" || builder == "sbvh")
+        return BvhBuilderType::SpatialSplit;
+    else
+        return std::nullopt;
+}
+
+std::string BvhBuildOptions::getBuilderName(BvhBuilderType type)
+{
+    switch (type) {
+    case BvhBuilderType::SweepSAH:
+        return "sweep_sah";
+    case BvhBuilderType::BinnedSAH:
+        return "binned_sah";
+    case BvhBuilderType::LBVH:
+        return "lbvh";
+    case BvhBuilderType::PLOC:
+        return "ploc";
+    case BvhBuilderType::SpatialSplit:
+        return "spatial_split";
+    }
+    return "unknown";
+}
+
+std::vector<std::string> BvhBuildOptions::getAvailableBuilders()
+{
+    return { "sweep_sah", "binned_sah", "lbvh", "ploc", "spatial_split" };
+}
+} // namespace IG
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "IG_Config.h"
+
+#include <optional>
+
+namespace IG {
+enum class BvhBuilderType {
+    SweepSAH = 0, // Full sweep over sorted centers. High quality, but slow
+    BinnedSAH,    // Binned SAH approximation. Good quality, fast
+    LBVH,         // Linear BVH based on morton codes. Fastest, but low quality
+    PLOC,         // Parallel locally ordered clustering. Good quality, fast
+    SpatialSplit  // SAH with spatial splits. Best quality for triangles, slowest. Other primitives fall back to PLOC
+};
+
+/// Choice of builder and optimization passes used to construct a BVH
+struct BvhBuildOptions {
+    BvhBuilderType Builder  = BvhBuilderType::SpatialSplit;
+    bool Reinsertion        = true; // Parallel reinsertion optimization reducing the SAH cost after the build
+    bool LayoutOptimization = true; // Reorder nodes in memory for better locality while traversing
+
+    /// Fast builds for iterative previews
+    static BvhBuildOptions makeFast();
+    /// Compromise between build time and traversal speed
+    static BvhBuildOptions makeBalanced();
+    /// Best traversal speed for final frames. This is the default
+    static BvhBuildOptions makeQuality();
+
+    /// Returns options for the given preset name or nothing if unknown
+    static std::optional<BvhBuildOptions> fromPreset(const std::string& name);
+    static std::vector<std::string> getAvailablePresets();
+
+    static std::optional<BvhBuilderType> getBuilderFromString(const std::string& name);
+    static std::string getBuilderName(BvhBuilderType type);
+    static std::vector<std::string> getAvailableBuilders();
+};
+
+/// Statistics of a single build. The SAH cost is computed for the binary tree before it is collapsed to the final arity
+struct BvhBuildStatistics {
+    float BuildMS    = 0;
+    float SAHCost    = 0;
+    size_t NodeCount = 0;
+};
+} // namespace IG
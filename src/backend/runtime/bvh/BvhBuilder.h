@@ -0,0 +1,119 @@
+#pragma once
+
+#include "BvhBuildOptions.h"
+
+IG_BEGIN_IGNORE_WARNINGS
+#include <bvh/binned_sah_builder.hpp>
+#include <bvh/bvh.hpp>
+#include <bvh/leaf_collapser.hpp>
+#include <bvh/linear_bvh_builder.hpp>
+#include <bvh/locally_ordered_clustering_builder.hpp>
+#include <bvh/node_layout_optimizer.hpp>
+#include <bvh/parallel_reinsertion_optimizer.hpp>
+#include <bvh/spatial_split_bvh_builder.hpp>
+#include <bvh/sweep_sah_builder.hpp>
+IG_END_IGNORE_WARNINGS
+
+#include <chrono>
+
+namespace IG {
+/// Compute the SAH cost relative to the root node with unit costs for traversal and intersection
+inline float compute_sah_cost(const bvh::Bvh<float>& bvh)
+{
+    const auto half_area = [](const bvh::Bvh<float>::Node& node) {
+        const float dx = node.bounds[1] - node.bounds[0];
+        const float dy = node.bounds[3] - node.bounds[2];
+        const float dz = node.bounds[5] - node.bounds[4];
+        return dx * dy + dy * dz + dz * dx;
+    };
+
+    if (bvh.node_count == 0)
+        return 0;
+
+    const float root_area = half_area(bvh.nodes[0]);
+    if (root_area <= 0)
+        return 0;
+
+    double cost = 0;
+    for (size_t i = 0; i < bvh.node_count; ++i) {
+        const auto& node = bvh.nodes[i];
+        cost += half_area(node) * (node.is_leaf() ? node.primitive_count : 1);
+    }
+    return (float)(cost / root_area);
+}
+
+template <typename T, typename = void>
+struct IsSplittablePrimitive : std::false_type {
+};
+
+template <typename T>
+struct IsSplittablePrimitive<T, std::void_t<decltype(std::declval<const T&>().split(size_t(0), 0.0f))>> : std::true_type {
+};
+
+/// Build a binary bvh with the given options. The primitives have to provide bounding_box() and center()
+template <typename Primitive>
+inline bvh::Bvh<float> build_binary_bvh(Primitive* primitives, size_t count, const BvhBuildOptions& options, bool collapse_leaves, BvhBuildStatistics* stats = nullptr)
+{
+    using Bvh = bvh::Bvh<float>;
+
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    BvhBuilderType type = options.Builder;
+    if constexpr (!IsSplittablePrimitive<Primitive>::value) {
+        if (type == BvhBuilderType::SpatialSplit)
+            type = BvhBuilderType::PLOC;
+    }
+
+    auto [bboxes, centers] = bvh::compute_bounding_boxes_and_centers(primitives, count);
+    auto global_bbox       = bvh::compute_bounding_boxes_union(bboxes.get(), count);
+
+    Bvh bvh;
+    switch (type) {
+    case BvhBuilderType::SweepSAH: {
+        bvh::SweepSahBuilder<Bvh> builder(bvh);
+        builder.build(global_bbox, bboxes.get(), centers.get(), count);
+    } break;
+    case BvhBuilderType::BinnedSAH: {
+        bvh::BinnedSahBuilder<Bvh, 16> builder(bvh);
+        builder.build(global_bbox, bboxes.get(), centers.get(), count);
+    } break;
+    case BvhBuilderType::LBVH: {
+        bvh::LinearBvhBuilder<Bvh, uint32> builder(bvh);
+        builder.build(global_bbox, bboxes.get(), centers.get(), count);
+    } break;
+    case BvhBuilderType::PLOC: {
+        bvh::LocallyOrderedClusteringBuilder<Bvh, uint32> builder(bvh);
+        builder.build(global_bbox, bboxes.get(), centers.get(), count);
+    } break;
+    case BvhBuilderType::SpatialSplit:
+        if constexpr (IsSplittablePrimitive<Primitive>::value) {
+            bvh::SpatialSplitBvhBuilder<Bvh, Primitive, 64> builder(bvh);
+            builder.build(global_bbox, primitives, bboxes.get(), centers.get(), count);
+        }
+        break;
+    }
+
+    if (options.Reinsertion) {
+        bvh::ParallelReinsertionOptimizer parallel_optimizer(bvh);
+        parallel_optimizer.optimize();
+    }
+
+    if (collapse_leaves) {
+        bvh::LeafCollapser leaf_optimizer(bvh);
+        leaf_optimizer.collapse();
+    }
+
+    if (options.LayoutOptimization) {
+        bvh::NodeLayoutOptimizer layout_optimizer(bvh);
+        layout_optimizer.optimize();
+    }
+
+    if (stats) {
+        stats->BuildMS   = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        stats->SAHCost   = compute_sah_cost(bvh);
+        stats->NodeCount = bvh.node_count;
+    }
+
+    return bvh;
+}
+} // namespace IG
@@ -1,17 +1,11 @@
 #pragma once
 
+#include "BvhBuilder.h"
 #include "BvhNAdapter.h"
 #include "Target.h"
 #include "math/BoundingBox.h"
 
 IG_BEGIN_IGNORE_WARNINGS
-#include <bvh/bvh.hpp>
-#include <bvh/leaf_collapser.hpp>
-#include <bvh/locally_ordered_clustering_builder.hpp>
-#include <bvh/node_layout_optimizer.hpp>
-#include <bvh/parallel_reinsertion_optimizer.hpp>
-#include <bvh/spatial_split_bvh_builder.hpp>
-#include <bvh/sweep_sah_builder.hpp>
 #include <bvh/triangle.hpp>
 IG_END_IGNORE_WARNINGS
 
@@ -99,27 +93,12 @@ protected:
 template <size_t N, template <typename> typename Allocator>
 inline void build_scene_bvh(std::vector<typename BvhNEnt<N>::Node, Allocator<typename BvhNEnt<N>::Node>>& nodes,
                             std::vector<EntityLeaf1, Allocator<EntityLeaf1>>& objs,
-                            std::vector<EntityObject, Allocator<EntityObject>>& primitives)
+                            std::vector<EntityObject, Allocator<EntityObject>>& primitives,
+                            const BvhBuildOptions& options = BvhBuildOptions(),
+                            BvhBuildStatistics* stats      = nullptr)
 {
-    using Bvh = bvh::Bvh<float>;
-    // using BvhBuilder = bvh::SweepSahBuilder<Bvh>;
-    using BvhBuilder = bvh::LocallyOrderedClusteringBuilder<Bvh, uint32>;
-
-    auto [bboxes, centers] = bvh::compute_bounding_boxes_and_centers(primitives.data(), primitives.size());
-    auto global_bbox       = bvh::compute_bounding_boxes_union(bboxes.get(), primitives.size());
-
-    Bvh bvh;
-    BvhBuilder builder(bvh);
-    builder.build(global_bbox, bboxes.get(), centers.get(), primitives.size());
-
-    bvh::ParallelReinsertionOptimizer parallel_optimizer(bvh);
-    parallel_optimizer.optimize();
-
-    bvh::LeafCollapser leaf_optimizer(bvh);
-    leaf_optimizer.collapse();
-
-    bvh::NodeLayoutOptimizer layout_optimizer(bvh);
-    layout_optimizer.optimize();
+    // Spatial splits are not available for entities and fall back to PLOC
+    const auto bvh = build_binary_bvh(primitives.data(), primitives.size(), options, true, stats);
 
     BvhNEntAdapter<N, Allocator> adapter(nodes, objs);
     adapter.adapt(bvh, primitives);
@@ -1,18 +1,12 @@
 #pragma once
 
+#include "BvhBuilder.h"
 #include "BvhNAdapter.h"
 #include "Target.h"
 #include "math/Triangle.h"
 #include "mesh/TriMesh.h"
 
 IG_BEGIN_IGNORE_WARNINGS
-#include <bvh/bvh.hpp>
-#include <bvh/leaf_collapser.hpp>
-#include <bvh/locally_ordered_clustering_builder.hpp>
-#include <bvh/node_layout_optimizer.hpp>
-#include <bvh/parallel_reinsertion_optimizer.hpp>
-#include <bvh/spatial_split_bvh_builder.hpp>
-#include <bvh/sweep_sah_builder.hpp>
 #include <bvh/triangle.hpp>
 IG_END_IGNORE_WARNINGS
 
@@ -163,13 +157,10 @@ protected:
 template <size_t N, size_t M, template <typename> typename Allocator>
 inline void build_bvh(const TriMesh& tri_mesh,
                       std::vector<typename BvhNTriM<N, M>::Node, Allocator<typename BvhNTriM<N, M>::Node>>& nodes,
-                      std::vector<typename BvhNTriM<N, M>::Tri, Allocator<typename BvhNTriM<N, M>::Tri>>& tris)
+                      std::vector<typename BvhNTriM<N, M>::Tri, Allocator<typename BvhNTriM<N, M>::Tri>>& tris,
+                      const BvhBuildOptions& options = BvhBuildOptions(),
+                      BvhBuildStatistics* stats      = nullptr)
 {
-    using Bvh        = bvh::Bvh<float>;
-    using BvhBuilder = bvh::SpatialSplitBvhBuilder<Bvh, TriangleProxy, 64>;
-    // using BvhBuilder = bvh::LocallyOrderedClusteringBuilder<Bvh, uint32>;
-    // using BvhBuilder = bvh::SweepSahBuilder<Bvh>;
-
     const size_t num_tris = tri_mesh.indices.size() / 4;
     std::vector<TriangleProxy> primitives(num_tris);
     for (size_t i = 0; i < num_tris; ++i) {
@@ -181,22 +172,7 @@ inline void build_bvh(const TriMesh& tri_mesh,
         primitives[i].prim_id = (int)i;
     }
 
-    auto [bboxes, centers] = bvh::compute_bounding_boxes_and_centers(primitives.data(), primitives.size());
-    auto global_bbox       = bvh::compute_bounding_boxes_union(bboxes.get(), primitives.size());
-
-    Bvh bvh;
-    BvhBuilder builder(bvh);
-    builder.build(global_bbox, primitives.data(), bboxes.get(), centers.get(), primitives.size());
-    // builder.build(global_bbox, bboxes.get(), centers.get(), primitives.size());
-
-    bvh::ParallelReinsertionOptimizer parallel_optimizer(bvh);
-    parallel_optimizer.optimize();
-
-    // bvh::LeafCollapser leaf_optimizer(bvh);
-    // leaf_optimizer.collapse();
-
-    bvh::NodeLayoutOptimizer layout_optimizer(bvh);
-    layout_optimizer.optimize();
+    const auto bvh = build_binary_bvh(primitives.data(), primitives.size(), options, false, stats);
 
     BvhNTriMAdapter<N, M, Allocator> adapter(nodes, tris);
     adapter.adapt(bvh, primitives);
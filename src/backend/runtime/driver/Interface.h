@@ -10,27 +10,37 @@ namespace IG {
 struct SceneDatabase;
 struct Ray;
 class Statistics;
+class Timeline;
 class Logger;
 } // namespace IG
 
 // Not in namespace IG
 struct DriverSetupSettings {
-    const char* driver_filename = nullptr;
-    size_t framebuffer_width    = 0;
-    size_t framebuffer_height   = 0;
-    IG::SceneDatabase* database = nullptr;
-    bool acquire_stats          = false;
-    size_t aov_count            = false;
+    const char* driver_filename    = nullptr;
+    size_t framebuffer_width       = 0;
+    size_t framebuffer_height      = 0;
+    IG::SceneDatabase* database    = nullptr;
+    bool acquire_stats             = false;
+    bool acquire_timeline          = false; // Record begin and end of tiles, shader launches and sections for each thread
+    size_t aov_count               = false;
+    const char* shader_cache_dir   = nullptr; // Root directory of the persistent shader cache. Disabled if null
+    bool sort_primary_out_of_place = false;   // Sort primary rays into a second stream instead of swapping them in place. Only used by the CPU
+    bool sort_primary_by_material  = false;   // Sort primary rays by material instead of entity. Only used by the CPU
+
+    float adaptive_threshold = 0; // Relative error below which a pixel is not sampled anymore. Disabled if zero. Only used by the CPU
+    size_t adaptive_warmup   = 0; // Iterations before a pixel is allowed to converge. The last AOV is expected to be the second moment
 
     IG::Logger* logger = nullptr;
 };
 
 struct DriverRenderSettings {
-    const IG::Ray* rays = nullptr; // If non-null, width contains the number of rays and height is set to 1
-    size_t device       = 0;
-    size_t spi          = 8;
-    size_t work_width   = 0;
-    size_t work_height  = 0;
+    const IG::Ray* rays   = nullptr; // If non-null, width contains the number of rays and height is set to 1
+    size_t ray_generation = 0;       // Changes whenever a new list of rays is given
+    bool rays_normalized  = false;   // If true, the directions of the rays are normalized already and can be used without conversion
+    size_t device         = 0;
+    size_t spi            = 8;
+    size_t work_width     = 0;
+    size_t work_height    = 0;
     IG::TechniqueVariantInfo info;
 };
 
@@ -41,11 +51,14 @@ using DriverResizeFramebufferFunction = void (*)(size_t, size_t);
 using DriverGetFramebufferFunction    = const float* (*)(size_t);
 using DriverClearFramebufferFunction  = void (*)(int);
 using DriverGetStatisticsFunction     = const IG::Statistics* (*)();
+using DriverGetTimelineFunction       = const IG::Timeline* (*)();
+using DriverActivePixelCountFunction  = size_t (*)();
 
 using DriverTonemapFunction   = void (*)(size_t, uint32_t*, const IG::TonemapSettings&);
 using DriverImageInfoFunction = void (*)(size_t, const IG::ImageInfoSettings&, IG::ImageInfoOutput&);
 
-using DriverCompileSourceFunction = void* (*)(const char*, const char*, bool);
+using DriverCompileSourceFunction        = void* (*)(const char*, const char*, bool);
+using DriverUpdateCustomDyntableFunction = void (*)(const char*);
 
 struct DriverInterface {
     IG::uint32 MajorVersion;
@@ -58,7 +71,10 @@ struct DriverInterface {
     DriverGetFramebufferFunction GetFramebufferFunction;
     DriverClearFramebufferFunction ClearFramebufferFunction;
     DriverGetStatisticsFunction GetStatisticsFunction;
+    DriverGetTimelineFunction GetTimelineFunction;
+    DriverActivePixelCountFunction ActivePixelCountFunction;
     DriverTonemapFunction TonemapFunction;
     DriverImageInfoFunction ImageInfoFunction;
     DriverCompileSourceFunction CompileSourceFunction;
+    DriverUpdateCustomDyntableFunction UpdateCustomDyntableFunction;
 };
\ No newline at end of file
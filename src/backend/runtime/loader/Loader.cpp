@@ -17,22 +17,32 @@ namespace IG {
 bool Loader::load(const LoaderOptions& opts, LoaderResult& result)
 {
     LoaderContext ctx;
-    ctx.Database            = &result.Database;
-    ctx.FilePath            = opts.FilePath;
-    ctx.Target              = opts.Target;
-    ctx.EnablePadding       = doesTargetRequirePadding(ctx.Target);
-    ctx.Scene               = opts.Scene;
-    ctx.CameraType          = opts.CameraType;
-    ctx.TechniqueType       = opts.TechniqueType;
-    ctx.PixelSamplerType    = opts.PixelSamplerType;
-    ctx.SamplesPerIteration = opts.SamplesPerIteration;
-    ctx.IsTracer            = opts.IsTracer;
-    ctx.FilmWidth           = opts.FilmWidth;
-    ctx.FilmHeight          = opts.FilmHeight;
-    ctx.Lights              = std::make_unique<LoaderLight>();
+    ctx.Database                  = &result.Database;
+    ctx.Parameters                = &result.Parameters;
+    ctx.FilePath                  = opts.FilePath;
+    ctx.Target                    = opts.Target;
+    ctx.EnablePadding             = doesTargetRequirePadding(ctx.Target);
+    ctx.Scene                     = opts.Scene;
+    ctx.CameraType                = opts.CameraType;
+    ctx.TechniqueType             = opts.TechniqueType;
+    ctx.PixelSamplerType          = opts.PixelSamplerType;
+    ctx.SamplesPerIteration       = opts.SamplesPerIteration;
+    ctx.IsTracer                  = opts.IsTracer;
+    ctx.UseMaterialParameterTable = opts.UseMaterialParameterTable;
+    ctx.SortPrimaryByMaterial     = opts.SortPrimaryByMaterial;
+    ctx.FilmWidth                 = opts.FilmWidth;
+    ctx.FilmHeight                = opts.FilmHeight;
+    ctx.BVHOptions                = opts.BVHOptions;
+    ctx.SceneCache                = SceneCache(opts.SceneCacheDir, opts.Target);
+    ctx.Lights                    = std::make_unique<LoaderLight>();
 
     ctx.Lights->prepare(ctx);
 
+    if (ctx.UseMaterialParameterTable) {
+        for (const auto& pair : ctx.Scene.bsdfs())
+            ctx.MaterialParameterOwners[pair.second.get()] = pair.first;
+    }
+
     // Load content
     if (!LoaderShape::load(ctx, result))
         return false;
@@ -65,6 +75,10 @@ bool Loader::load(const LoaderOptions& opts, LoaderResult& result)
     else
         IG_LOG(L_DEBUG) << "Generating shaders for " << ctx.TechniqueInfo.Variants.size() << " variants" << std::endl;
 
+    const auto material_groups = HitShader::groupMaterials(ctx);
+    if (material_groups.size() != ctx.Environment.Materials.size())
+        IG_LOG(L_DEBUG) << "Sharing " << material_groups.size() << " hit shaders between " << ctx.Environment.Materials.size() << " materials" << std::endl;
+
     result.TechniqueVariants.resize(ctx.TechniqueInfo.Variants.size());
     for (size_t i = 0; i < ctx.TechniqueInfo.Variants.size(); ++i) {
         auto& variant               = result.TechniqueVariants[i];
@@ -91,15 +105,17 @@ bool Loader::load(const LoaderOptions& opts, LoaderResult& result)
             return false;
         }
 
-        // Generate Hit Shader
-        for (size_t j = 0; j < ctx.Environment.Materials.size(); ++j) {
-            IG_LOG(L_DEBUG) << "Generating hit shader " << j << " for variant " << i << std::endl;
-            std::string shader = HitShader::setup(j, ctx);
+        // Generate Hit Shader. Materials of the same group share the exact same shader, which is only compiled once
+        variant.HitShaders.resize(ctx.Environment.Materials.size());
+        for (const auto& group : material_groups) {
+            IG_LOG(L_DEBUG) << "Generating hit shader " << group.front() << " for variant " << i << std::endl;
+            std::string shader = HitShader::setup(group, ctx);
             if (shader.empty()) {
-                IG_LOG(L_ERROR) << "Constructed empty hit shader for material " << j << "." << std::endl;
+                IG_LOG(L_ERROR) << "Constructed empty hit shader for material " << group.front() << "." << std::endl;
                 return false;
             }
-            variant.HitShaders.push_back(shader);
+            for (size_t j : group)
+                variant.HitShaders[j] = shader;
         }
 
         // Generate Advanced Shadow Shaders if requested
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "CameraOrientation.h"
+#include "ParameterSet.h"
 #include "Parser.h"
+#include "Statistics.h"
 #include "Target.h"
 #include "TechniqueInfo.h"
+#include "bvh/BvhBuildOptions.h"
 #include "table/SceneDatabase.h"
 
 namespace IG {
@@ -20,6 +23,10 @@ struct LoaderOptions {
     size_t FilmHeight;
     size_t SamplesPerIteration; // Only a recommendation!
     bool IsTracer;
+    bool UseMaterialParameterTable;
+    bool SortPrimaryByMaterial;          // Hit shaders are launched per material and get the entity of each ray from the stream
+    BvhBuildOptions BVHOptions;          // Default for all shapes and the scene BVH
+    std::filesystem::path SceneCacheDir; // Path to a directory used to cache shapes and BVHs between runs. Disabled if empty
 };
 
 struct LoaderResult {
@@ -27,6 +34,8 @@ struct LoaderResult {
     std::vector<TechniqueVariant> TechniqueVariants;
     IG::TechniqueInfo TechniqueInfo;
     IG::CameraOrientation CameraOrientation;
+    ParameterSet Parameters; // Parameters resolved to slots while generating the shaders
+    LoadingTimings Timings;  // Only shape loading and BVH building are set by the loader
 };
 
 class Loader {
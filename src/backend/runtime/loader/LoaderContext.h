@@ -1,8 +1,11 @@
 #pragma once
 
 #include "LoaderEnvironment.h"
+#include "ParameterSet.h"
+#include "SceneCache.h"
 #include "Target.h"
 #include "TechniqueInfo.h"
+#include "bvh/BvhBuildOptions.h"
 
 #include <any>
 #include <filesystem>
@@ -29,13 +32,22 @@ struct LoaderContext {
 
     bool IsTracer = false;
 
+    BvhBuildOptions BVHOptions; // Default for all shapes and the scene BVH. Shapes might override it
+    IG::SceneCache SceneCache;  // Disabled if no directory was given
+
+    bool UseMaterialParameterTable = false;
+    std::unordered_map<const Parser::Object*, std::string> MaterialParameterOwners; // Objects allowed to put parameters into the material parameter table
+
+    bool SortPrimaryByMaterial = false; // Hit shaders get the entity of each ray from the stream instead of a fixed one
+
     size_t CurrentTechniqueVariant;
     inline const IG::TechniqueVariantInfo CurrentTechniqueVariantInfo() const { return TechniqueInfo.Variants[CurrentTechniqueVariant]; }
 
     std::unordered_map<std::string, std::any> ExportedData; // Cache with already exported data and auxillary info
 
     LoaderEnvironment Environment;
-    SceneDatabase* Database = nullptr;
+    SceneDatabase* Database  = nullptr;
+    ParameterSet* Parameters = nullptr; // Registry used to resolve parameters to slots of the parameter block
 
     size_t EntityCount;
 
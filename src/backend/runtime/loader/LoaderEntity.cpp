@@ -3,6 +3,7 @@
 #include "LoaderLight.h"
 #include "Logger.h"
 #include "bvh/SceneBVHAdapter.h"
+#include "serialization/HashSerializer.h"
 #include "serialization/VectorSerializer.h"
 
 #include <chrono>
@@ -10,13 +11,31 @@
 namespace IG {
 using namespace Parser;
 
+// The scene BVH depends only on the entities, the options and the target
+static uint64 compute_bvh_key(const std::vector<EntityObject>& input, const LoaderContext& ctx)
+{
+    HashSerializer hasher(ctx.SceneCache.seed());
+    hasher.write((uint32)ctx.BVHOptions.Builder);
+    hasher.write(ctx.BVHOptions.Reinsertion);
+    hasher.write(ctx.BVHOptions.LayoutOptimization);
+    for (const auto& obj : input) {
+        hasher.write(obj.BBox.min);
+        hasher.write(obj.BBox.max);
+        hasher.write(obj.ShapeID);
+        hasher.write(obj.Local);
+    }
+    return hasher.hash();
+}
+
 template <size_t N>
-inline static void setup_bvh(std::vector<EntityObject>& input, LoaderResult& result)
+inline static void setup_bvh(std::vector<EntityObject>& input, const BvhBuildOptions& options, LoaderResult& result)
 {
     using Node = typename BvhNEnt<N>::Node;
     std::vector<Node> nodes;
     std::vector<EntityLeaf1> objs;
-    build_scene_bvh<N>(nodes, objs, input);
+    BvhBuildStatistics stats;
+    build_scene_bvh<N>(nodes, objs, input, options, &stats);
+    IG_LOG(L_DEBUG) << "Scene BVH has SAH cost " << stats.SAHCost << " with " << stats.NodeCount << " nodes" << std::endl;
 
     result.Database.SceneBVH.Nodes.resize(sizeof(Node) * nodes.size());
     std::memcpy(result.Database.SceneBVH.Nodes.data(), nodes.data(), result.Database.SceneBVH.Nodes.size());
@@ -85,7 +104,8 @@ bool LoaderEntity::load(LoaderContext& ctx, LoaderResult& result)
         }
 
         // Extract entity information
-        Transformf transform = child->property("transform").getTransform();
+        // Shapes sharing their data with differently transformed shapes have to be transformed by the entity
+        Transformf transform = ctx.Environment.computeEntityTransform(shapeName, child->property("transform").getTransform());
         transform.makeAffine();
 
         const auto& shape = ctx.Environment.Shapes[shapeID];
@@ -155,13 +175,19 @@ bool LoaderEntity::load(LoaderContext& ctx, LoaderResult& result)
 
     // Build bvh (keep in mind that this BVH has no pre-padding as in the case for shape BVHs)
     IG_LOG(L_DEBUG) << "Generating BVH for scene" << std::endl;
-    const auto start2 = std::chrono::high_resolution_clock::now();
-    if (ctx.Target == Target::NVVM || ctx.Target == Target::AMDGPU) {
-        setup_bvh<2>(in_objs, result);
-    } else if (ctx.Target == Target::GENERIC || ctx.Target == Target::SINGLE || ctx.Target == Target::ASIMD || ctx.Target == Target::SSE42) {
-        setup_bvh<4>(in_objs, result);
+    const auto start2      = std::chrono::high_resolution_clock::now();
+    const uint64 cache_key = ctx.SceneCache.isEnabled() ? compute_bvh_key(in_objs, ctx) : 0;
+    if (ctx.SceneCache.loadSceneBVH(cache_key, result.Database.SceneBVH)) {
+        IG_LOG(L_DEBUG) << "Loaded scene BVH from scene cache" << std::endl;
     } else {
-        setup_bvh<8>(in_objs, result);
+        if (ctx.Target == Target::NVVM || ctx.Target == Target::AMDGPU) {
+            setup_bvh<2>(in_objs, ctx.BVHOptions, result);
+        } else if (ctx.Target == Target::GENERIC || ctx.Target == Target::SINGLE || ctx.Target == Target::ASIMD || ctx.Target == Target::SSE42) {
+            setup_bvh<4>(in_objs, ctx.BVHOptions, result);
+        } else {
+            setup_bvh<8>(in_objs, ctx.BVHOptions, result);
+        }
+        ctx.SceneCache.storeSceneBVH(cache_key, result.Database.SceneBVH);
     }
     IG_LOG(L_DEBUG) << "Building Scene BVH took " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start2).count() / 1000.0f << " seconds" << std::endl;
 
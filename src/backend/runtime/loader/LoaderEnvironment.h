@@ -56,13 +56,23 @@ inline bool operator==(const Material& a, const Material& b)
 // TODO: Refactor this to the actual loading classes
 struct LoaderEnvironment {
     std::vector<Shape> Shapes;
-    std::unordered_map<std::string, uint32> ShapeIDs;
+    std::unordered_map<std::string, uint32> ShapeIDs;            // Multiple shapes might share the same id
+    std::unordered_map<std::string, Transformf> ShapeTransforms; // Transforms of shared shapes, which have to be applied by the entities
     std::unordered_map<std::string, Entity> EmissiveEntities;
     std::vector<Material> Materials;
     std::unordered_map<uint32, PlaneShape> PlaneShapes; // Used for special optimization
 
     BoundingBox SceneBBox;
     float SceneDiameter = 0.0f;
+
+    /// Transform of an entity with the given transform referencing the given shape
+    inline Transformf computeEntityTransform(const std::string& shapeName, const Transformf& entityTransform) const
+    {
+        const auto shapeTransform = ShapeTransforms.find(shapeName);
+        if (shapeTransform != ShapeTransforms.end())
+            return entityTransform * shapeTransform->second;
+        return entityTransform;
+    }
 };
 
 } // namespace IG
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "LoaderLight.h"
 #include "CDF.h"
+#include "LightTree.h"
 #include "Loader.h"
 #include "LoaderTexture.h"
 #include "LoaderUtils.h"
@@ -290,7 +291,7 @@ static void light_area(size_t id, std::ostream& stream, const std::string& name,
                << ");" << std::endl;
     } else {
         const auto shape    = tree.context().Environment.Shapes[shape_id];
-        size_t shape_offset = tree.context().Database->ShapeTable.lookups()[shape_id].Offset;
+        size_t shape_offset = tree.context().Database->ShapeTable.lookup(shape_id).Offset;
 
         stream << "  let ae_" << LoaderUtils::escapeIdentifier(name) << " = make_shape_area_emitter(" << inline_entity(entity, shape_id)
                << ", device.load_specific_shape(" << shape.FaceCount << ", " << shape.VertexCount << ", " << shape.NormalCount << ", " << shape.TexCount << ", " << shape_offset << ", dtb.shapes));" << std::endl;
@@ -860,6 +861,15 @@ void LoaderLight::embedLights(LoaderContext& ctx)
         mSimpleAreaLightCounter = 0;
 }
 
+static float estimateLightPower(const std::shared_ptr<Parser::Object>& light, const LoaderContext& ctx)
+{
+    for (size_t i = 0; _generators[i].Loader; ++i) {
+        if (_generators[i].Name == light->pluginType())
+            return _generators[i].Power(light, ctx);
+    }
+    return 0;
+}
+
 std::filesystem::path LoaderLight::generateLightSelectionCDF(LoaderContext& ctx)
 {
     const std::string exported_id = "_light_cdf_";
@@ -876,24 +886,86 @@ std::filesystem::path LoaderLight::generateLightSelectionCDF(LoaderContext& ctx)
 
     std::vector<float> estimated_powers;
     estimated_powers.reserve(mOrderedLights.size());
-    for (const auto& pair : mOrderedLights) {
-        bool found = false;
-        for (size_t i = 0; _generators[i].Loader; ++i) {
-            if (_generators[i].Name == pair.second->pluginType()) {
-                float power = _generators[i].Power(pair.second, ctx);
-                estimated_powers.push_back(power);
-                // std::cout << power << std::endl;
-                found = true;
-                break;
-            }
-        }
-        if (!found)
-            estimated_powers.push_back(0);
-    }
+    for (const auto& pair : mOrderedLights)
+        estimated_powers.push_back(estimateLightPower(pair.second, ctx));
 
     CDF::computeForArray(estimated_powers, path);
 
     ctx.ExportedData[exported_id] = path;
     return path;
 }
+
+// Spatial and directional bounds of the emission of a light. Returns false if the light has no finite extent
+static bool computeLightBounds(const std::shared_ptr<Parser::Object>& light, const LoaderContext& ctx, BoundingBox& bbox, Vector3f& axis, float& thetaO, float& thetaE)
+{
+    const std::string type = light->pluginType();
+    if (type == "point") {
+        bbox   = BoundingBox(light->property("position").getVector3());
+        axis   = Vector3f::UnitZ();
+        thetaO = Pi;
+        thetaE = Pi / 2;
+        return true;
+    } else if (type == "spot") {
+        bbox   = BoundingBox(light->property("position").getVector3());
+        axis   = extractEA(light).toDirection();
+        thetaO = 0;
+        thetaE = light->property("cutoff").getNumber(30) * Deg2Rad;
+        return true;
+    } else if (type == "area") {
+        const std::string entityName = light->property("entity").getString();
+        if (!ctx.Environment.EmissiveEntities.count(entityName))
+            return false;
+
+        const Entity& entity  = ctx.Environment.EmissiveEntities.at(entityName);
+        const uint32 shape_id = ctx.Environment.ShapeIDs.at(entity.Shape);
+
+        bbox   = ctx.Environment.Shapes[shape_id].BoundingBox.transformed(entity.Transform);
+        thetaE = Pi / 2;
+        if (ctx.Environment.PlaneShapes.count(shape_id) > 0) {
+            const auto& shape = ctx.Environment.PlaneShapes.at(shape_id);
+            axis              = (entity.Transform.linear() * shape.XAxis).cross(entity.Transform.linear() * shape.YAxis).normalized();
+            thetaO            = 0;
+        } else {
+            axis   = Vector3f::UnitZ();
+            thetaO = Pi;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+LoaderLight::LightTreeInfo LoaderLight::generateLightTree(LoaderContext& ctx)
+{
+    const std::string exported_id = "_light_tree_";
+
+    const auto data = ctx.ExportedData.find(exported_id);
+    if (data != ctx.ExportedData.end())
+        return std::any_cast<LightTreeInfo>(data->second);
+
+    LightTree tree;
+    for (size_t id = 0; id < mOrderedLights.size(); ++id) {
+        const auto& light = mOrderedLights[id].second;
+        const float power = estimateLightPower(light, ctx);
+
+        BoundingBox bbox;
+        Vector3f axis;
+        float thetaO, thetaE;
+        if (computeLightBounds(light, ctx, bbox, axis, thetaO, thetaE))
+            tree.addFinite((uint32)id, bbox, axis, thetaO, thetaE, power);
+        else
+            tree.addInfinite((uint32)id, power);
+    }
+
+    auto& treeData = ctx.Database->CustomTables["LightTree"].addLookup(0, 0, DefaultAlignment); // We do not make use of the typeid
+    tree.build(treeData, mOrderedLights.size());
+
+    LightTreeInfo info;
+    info.NodeCount           = tree.nodeCount();
+    info.InfiniteCount       = tree.infiniteCount();
+    info.InfiniteProbability = tree.infiniteProbability();
+
+    ctx.ExportedData[exported_id] = info;
+    return info;
+}
 } // namespace IG
\ No newline at end of file
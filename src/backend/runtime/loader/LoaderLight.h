@@ -11,6 +11,14 @@ public:
     std::string generate(ShadingTree& tree, bool skipArea);
     std::filesystem::path generateLightSelectionCDF(LoaderContext& ctx);
 
+    struct LightTreeInfo {
+        size_t NodeCount;
+        size_t InfiniteCount;
+        float InfiniteProbability;
+    };
+    /// Build a light tree and export it to the custom table 'LightTree'. This is cached for multiple calls
+    LightTreeInfo generateLightTree(LoaderContext& ctx);
+
     inline std::shared_ptr<Parser::Object> getByID(size_t id) const { return mOrderedLights.at(id).second; }
 
     inline bool hasAreaLights() const { return !mAreaLights.empty(); };
@@ -7,6 +7,7 @@
 #include "mesh/ObjFile.h"
 #include "mesh/PlyFile.h"
 
+#include "serialization/MemorySerializer.h"
 #include "serialization/VectorSerializer.h"
 
 #include <algorithm>
@@ -21,6 +22,8 @@
 #define IG_PARALLEL_LOAD_SHAPE
 // There is no reason to not build multiple BVHs in parallel
 #define IG_PARALLEL_BVH
+// All entries are independent after the layout of the table is known
+#define IG_PARALLEL_STORE
 
 namespace IG {
 
@@ -172,6 +175,101 @@ inline TriMesh setup_mesh_external(const std::string& name, const Object& elem,
     return {};
 }
 
+inline BvhBuildOptions setup_bvh_options(const std::string& name, const Object& elem, const LoaderContext& ctx)
+{
+    BvhBuildOptions options = ctx.BVHOptions;
+
+    const std::string preset = elem.property("bvh_preset").getString();
+    if (!preset.empty()) {
+        const auto preset_options = BvhBuildOptions::fromPreset(preset);
+        if (preset_options.has_value())
+            options = preset_options.value();
+        else
+            IG_LOG(L_WARNING) << "Shape '" << name << "': Unknown BVH preset '" << preset << "'. Using default instead" << std::endl;
+    }
+
+    const std::string builder = elem.property("bvh_builder").getString();
+    if (!builder.empty()) {
+        const auto builder_type = BvhBuildOptions::getBuilderFromString(builder);
+        if (builder_type.has_value())
+            options.Builder = builder_type.value();
+        else
+            IG_LOG(L_WARNING) << "Shape '" << name << "': Unknown BVH builder '" << builder << "'. Using default instead" << std::endl;
+    }
+
+    options.Reinsertion        = elem.property("bvh_reinsertion").getBool(options.Reinsertion);
+    options.LayoutOptimization = elem.property("bvh_layout").getBool(options.LayoutOptimization);
+    return options;
+}
+
+// Identical for all shapes with the same type and parameters, ignoring the transform.
+// Referenced files are compared by their name only, as resolving them is costly and happens while loading anyway
+static std::string compute_definition_key(const Object& obj)
+{
+    std::vector<uint8> data;
+    VectorSerializer serializer(data, false);
+    serializer.write(obj.pluginType());
+    serializer.write(obj.baseDir().generic_u8string());
+
+    // The properties are stored in an unordered map, which has no stable order
+    std::vector<std::string> keys;
+    keys.reserve(obj.properties().size());
+    for (const auto& pair : obj.properties()) {
+        if (pair.first != "transform")
+            keys.push_back(pair.first);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    for (const auto& key : keys) {
+        const auto prop = obj.property(key);
+        serializer.write(key);
+        serializer.write((uint32)prop.type());
+        switch (prop.type()) {
+        case PT_NONE:
+        case PT_TRANSFORM:
+            break;
+        case PT_BOOL:
+            serializer.write(prop.getBool());
+            break;
+        case PT_INTEGER:
+            serializer.write(prop.getInteger());
+            break;
+        case PT_NUMBER:
+            serializer.write(prop.getNumber());
+            break;
+        case PT_STRING:
+            serializer.write(prop.getString());
+            break;
+        case PT_VECTOR2:
+            serializer.write(prop.getVector2());
+            break;
+        case PT_VECTOR3:
+            serializer.write(prop.getVector3());
+            break;
+        }
+    }
+
+    return std::string(data.begin(), data.end());
+}
+
+// Size of a single element written with Serializer::writeAligned
+template <typename T>
+constexpr size_t aligned_element_size(size_t alignment)
+{
+    return sizeof(T) + (alignment - sizeof(T) % alignment);
+}
+
+// Has to match the layout written in LoaderShape::load
+inline size_t compute_mesh_entry_size(const TriMesh& mesh)
+{
+    constexpr size_t Vector3Size = aligned_element_size<StVector3f>(DefaultAlignment);
+    return 4 * sizeof(uint32)
+           + (mesh.vertices.size() + mesh.normals.size() + mesh.face_normals.size()) * Vector3Size
+           + mesh.indices.size() * sizeof(uint32)
+           + mesh.texcoords.size() * sizeof(StVector2f)
+           + mesh.face_inv_area.size() * sizeof(float);
+}
+
 template <size_t N, size_t T>
 struct BvhTemporary {
     std::vector<typename BvhNTriM<N, T>::Node, tbb::scalable_allocator<typename BvhNTriM<N, T>::Node>> nodes;
@@ -179,17 +277,19 @@ struct BvhTemporary {
 };
 
 template <size_t N, size_t T>
-static void setup_bvhs(const std::vector<TriMesh>& meshes, LoaderResult& result)
+static void setup_bvhs(const std::vector<std::string>& ids, const std::vector<TriMesh>& meshes, const std::vector<BvhBuildOptions>& options, LoaderResult& result)
 {
     // Preload map entries
     std::vector<BvhTemporary<N, T>> bvhs;
     bvhs.resize(meshes.size());
+    std::vector<BvhBuildStatistics> stats;
+    stats.resize(meshes.size());
 
     const auto build_mesh = [&](size_t id) {
         BvhTemporary<N, T>& tmp = bvhs[id];
         const TriMesh& mesh     = meshes.at(id);
         if (mesh.faceCount() > 0)
-            build_bvh<N, T>(mesh, tmp.nodes, tmp.tris);
+            build_bvh<N, T>(mesh, tmp.nodes, tmp.tris, options.at(id), &stats[id]);
     };
 
     // Start building!
@@ -207,37 +307,126 @@ static void setup_bvhs(const std::vector<TriMesh>& meshes, LoaderResult& result)
 #endif
     IG_LOG(L_DEBUG) << "Building BVHs took " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start1).count() / 1000.0f << " seconds" << std::endl;
 
-    // Write non-parallel
+    // Report the quality of the builds, weighted by the number of triangles
+    double weighted_cost = 0;
+    size_t total_faces   = 0;
+    for (size_t id = 0; id < meshes.size(); ++id) {
+        if (meshes[id].faceCount() == 0)
+            continue;
+
+        IG_LOG(L_DEBUG) << "Shape '" << ids[id] << "': Building BVH with " << BvhBuildOptions::getBuilderName(options[id].Builder) << " builder took " << stats[id].BuildMS / 1000.0f << " seconds with SAH cost " << stats[id].SAHCost << std::endl;
+        weighted_cost += stats[id].SAHCost * meshes[id].faceCount();
+        total_faces += meshes[id].faceCount();
+    }
+    if (total_faces > 0)
+        IG_LOG(L_DEBUG) << "Average SAH cost of shape BVHs is " << weighted_cost / total_faces << std::endl;
+
+    // Compute the layout up front, such that the table is allocated only once and all entries can be written in parallel
     IG_LOG(L_DEBUG) << "Storing BVHs ..." << std::endl;
     const auto start2 = std::chrono::high_resolution_clock::now();
-    for (const auto& bvh : bvhs) {
-        auto& bvhData = result.Database.BVHTable.addLookup(0, 0, DefaultAlignment);
-        VectorSerializer serializer(bvhData, false);
+
+    std::vector<size_t> sizes(bvhs.size());
+    for (size_t id = 0; id < bvhs.size(); ++id)
+        sizes[id] = 4 * sizeof(uint32) + bvhs[id].nodes.size() * sizeof(typename BvhNTriM<N, T>::Node) + bvhs[id].tris.size() * sizeof(typename BvhNTriM<N, T>::Tri);
+
+    const size_t first = result.Database.BVHTable.addLookups(0, 0, DefaultAlignment, sizes);
+
+    const auto store_bvh = [&](size_t id) {
+        const BvhTemporary<N, T>& bvh = bvhs[id];
+        MemorySerializer serializer(result.Database.BVHTable.entryData(first + id), sizes[id], false);
         serializer.write((uint32)bvh.nodes.size());
         serializer.write((uint32)bvh.tris.size()); // Not really needed, but just dump it out
         serializer.write((uint32)0);               // Padding
         serializer.write((uint32)0);               // Padding
         serializer.write(bvh.nodes, true);
         serializer.write(bvh.tris, true);
-    }
-    IG_LOG(L_DEBUG) << "Storing BVHs took " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start2).count() / 1000.0f << " seconds" << std::endl;
+        IG_ASSERT(serializer.position() == sizes[id], "Expected precomputed bvh size to match the written size");
+    };
+
+#ifdef IG_PARALLEL_STORE
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, bvhs.size()),
+                      [&](const tbb::blocked_range<size_t>& range) {
+                          for (size_t i = range.begin(); i != range.end(); ++i)
+                              store_bvh(i);
+                      });
+#else
+    for (size_t i = 0; i < bvhs.size(); ++i)
+        store_bvh(i);
+#endif
+    const size_t storeMS = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start2).count();
+    result.Timings.TableStoreMS += storeMS;
+    IG_LOG(L_DEBUG) << "Storing BVHs took " << storeMS / 1000.0f << " seconds" << std::endl;
 }
 
-bool LoaderShape::load(LoaderContext& ctx, LoaderResult& result)
+LoaderShape::Groups LoaderShape::group(const Parser::Scene& scene)
 {
+    Groups groups;
+
     // To make use of parallelization and workaround the map restrictions
     // we do have to construct a map
-    std::vector<std::string> ids(ctx.Scene.shapes().size());
-    std::transform(ctx.Scene.shapes().begin(), ctx.Scene.shapes().end(), ids.begin(),
+    groups.Names.resize(scene.shapes().size());
+    std::transform(scene.shapes().begin(), scene.shapes().end(), groups.Names.begin(),
                    [](const std::pair<std::string, std::shared_ptr<Object>>& pair) {
                        return pair.first;
                    });
 
+    std::unordered_map<std::string, uint32> definitions;
+    groups.UniqueIDs.resize(groups.Names.size());
+    for (size_t i = 0; i < groups.Names.size(); ++i) {
+        const auto child          = scene.shape(groups.Names[i]);
+        const auto [it, inserted] = definitions.try_emplace(compute_definition_key(*child), (uint32)groups.Representatives.size());
+        if (inserted) {
+            groups.Representatives.push_back(groups.Names[i]);
+            groups.BakeTransform.push_back(true);
+        } else if (child->property("transform").getTransform().matrix() != scene.shape(groups.Representatives[it->second])->property("transform").getTransform().matrix()) {
+            groups.BakeTransform[it->second] = false;
+        }
+        groups.UniqueIDs[i] = it->second;
+    }
+
+    return groups;
+}
+
+void LoaderShape::assign(const Groups& groups, const Parser::Scene& scene, LoaderEnvironment& env)
+{
+    for (size_t i = 0; i < groups.Names.size(); ++i) {
+        const uint32 shapeID          = groups.UniqueIDs[i];
+        env.ShapeIDs[groups.Names[i]] = shapeID;
+
+        const Transformf transform = scene.shape(groups.Names[i])->property("transform").getTransform();
+        if (!groups.BakeTransform[shapeID] && !transform.matrix().isIdentity())
+            env.ShapeTransforms[groups.Names[i]] = transform;
+    }
+}
+
+bool LoaderShape::load(LoaderContext& ctx, LoaderResult& result)
+{
+    // Skip loading of meshes and building of BVHs if nothing changed since the last run
+    uint64 cache_key = 0;
+    if (ctx.SceneCache.isEnabled()) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        cache_key        = ctx.SceneCache.computeShapeKey(ctx);
+        if (ctx.SceneCache.loadShapes(cache_key, ctx, result.Database)) {
+            result.Timings.ShapeLoadMS = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start).count();
+            IG_LOG(L_INFO) << "Loaded " << ctx.Environment.Shapes.size() << " shapes from scene cache in " << result.Timings.ShapeLoadMS / 1000.0f << " seconds" << std::endl;
+            return true;
+        }
+    }
+
+    const Groups groups                     = group(ctx.Scene);
+    const std::vector<std::string>& ids     = groups.Representatives;
+    const std::vector<bool>& bake_transform = groups.BakeTransform;
+
+    if (ids.size() < groups.Names.size())
+        IG_LOG(L_INFO) << "Sharing data of " << groups.Names.size() << " shapes between " << ids.size() << " unique shapes" << std::endl;
+
     // Preallocate mesh storage
     std::vector<TriMesh> meshes;
-    meshes.resize(ctx.Scene.shapes().size());
+    meshes.resize(ids.size());
     std::vector<BoundingBox> boxes;
-    boxes.resize(ctx.Scene.shapes().size());
+    boxes.resize(ids.size());
+    std::vector<BvhBuildOptions> bvh_options;
+    bvh_options.resize(ids.size());
 
     std::mutex plane_shape_mutex;
 
@@ -247,6 +436,8 @@ bool LoaderShape::load(LoaderContext& ctx, LoaderResult& result)
         const std::string name = ids.at(i);
         const auto child       = ctx.Scene.shape(name);
 
+        bvh_options[i] = setup_bvh_options(name, *child, ctx);
+
         TriMesh& mesh = meshes[i];
         if (child->pluginType() == "triangle") {
             mesh = setup_mesh_triangle(*child);
@@ -293,7 +484,8 @@ bool LoaderShape::load(LoaderContext& ctx, LoaderResult& result)
         if (child->property("face_normals").getBool())
             mesh.setupFaceNormalsAsVertexNormals();
 
-        if (!child->property("transform").getTransform().matrix().isIdentity())
+        // Shared shapes with different transforms keep the mesh in object space. The transform is applied by the entities instead
+        if (bake_transform[i] && !child->property("transform").getTransform().matrix().isIdentity())
             mesh.transform(child->property("transform").getTransform());
 
         // Check if shape is actually just a simple plane
@@ -327,12 +519,10 @@ bool LoaderShape::load(LoaderContext& ctx, LoaderResult& result)
 #endif
     IG_LOG(L_DEBUG) << "Loading of shapes took " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start1).count() / 1000.0f << " seconds" << std::endl;
 
-    // Write non-parallel
     IG_LOG(L_DEBUG) << "Storing triangle meshes..." << std::endl;
-    size_t counter    = 0;
     const auto start2 = std::chrono::high_resolution_clock::now();
-    for (const auto& pair : ctx.Scene.shapes()) {
-        const size_t id     = counter++;
+    std::vector<size_t> sizes(meshes.size());
+    for (size_t id = 0; id < meshes.size(); ++id) {
         const TriMesh& mesh = meshes.at(id);
 
         // Register shape into environment
@@ -343,19 +533,22 @@ bool LoaderShape::load(LoaderContext& ctx, LoaderResult& result)
         shape.FaceCount   = mesh.faceCount();
         shape.Area        = mesh.computeArea();
         shape.BoundingBox = boxes.at(id);
-
-        const uint32 shapeID = (uint32)ctx.Environment.Shapes.size();
         ctx.Environment.Shapes.push_back(shape);
-        ctx.Environment.ShapeIDs[pair.first] = shapeID;
 
         IG_ASSERT(mesh.face_normals.size() == mesh.faceCount(), "Expected valid face normals!");
         IG_ASSERT((mesh.indices.size() % 4) == 0, "Expected index buffer count to be a multiple of 4!");
 
-        // Export data:
-        IG_LOG(L_DEBUG) << "Generating triangle mesh for shape " << pair.first << std::endl;
+        sizes[id] = compute_mesh_entry_size(mesh);
+    }
+
+    assign(groups, ctx.Scene, ctx.Environment);
 
-        auto& meshData = result.Database.ShapeTable.addLookup(0, 0, DefaultAlignment); // TODO: No use of the typeid currently
-        VectorSerializer meshSerializer(meshData, false);
+    // Compute the layout up front, such that the table is allocated only once and all entries can be written in parallel
+    const size_t first = result.Database.ShapeTable.addLookups(0, 0, DefaultAlignment, sizes); // TODO: No use of the typeid currently
+
+    const auto store_mesh = [&](size_t id) {
+        const TriMesh& mesh = meshes[id];
+        MemorySerializer meshSerializer(result.Database.ShapeTable.entryData(first + id), sizes[id], false);
         meshSerializer.write((uint32)mesh.faceCount());
         meshSerializer.write((uint32)mesh.vertices.size());
         meshSerializer.write((uint32)mesh.normals.size());
@@ -366,16 +559,36 @@ bool LoaderShape::load(LoaderContext& ctx, LoaderResult& result)
         meshSerializer.write(mesh.indices, true);   // Already aligned
         meshSerializer.write(mesh.texcoords, true); // Aligned to 4*2 bytes
         meshSerializer.write(mesh.face_inv_area, true);
-    }
-    IG_LOG(L_DEBUG) << "Storing of shapes took " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start2).count() / 1000.0f << " seconds" << std::endl;
+        IG_ASSERT(meshSerializer.position() == sizes[id], "Expected precomputed mesh size to match the written size");
+    };
 
+#ifdef IG_PARALLEL_STORE
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, meshes.size()),
+                      [&](const tbb::blocked_range<size_t>& range) {
+                          for (size_t i = range.begin(); i != range.end(); ++i)
+                              store_mesh(i);
+                      });
+#else
+    for (size_t i = 0; i < meshes.size(); ++i)
+        store_mesh(i);
+#endif
+    result.Timings.TableStoreMS = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start2).count();
+    IG_LOG(L_DEBUG) << "Storing of shapes took " << result.Timings.TableStoreMS / 1000.0f << " seconds" << std::endl;
+    result.Timings.ShapeLoadMS = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start1).count();
+
+    const auto start3 = std::chrono::high_resolution_clock::now();
     if (ctx.Target == Target::NVVM || ctx.Target == Target::AMDGPU) {
-        setup_bvhs<2, 1>(meshes, result);
+        setup_bvhs<2, 1>(ids, meshes, bvh_options, result);
     } else if (ctx.Target == Target::GENERIC || ctx.Target == Target::SINGLE || ctx.Target == Target::ASIMD || ctx.Target == Target::SSE42) {
-        setup_bvhs<4, 4>(meshes, result);
+        setup_bvhs<4, 4>(ids, meshes, bvh_options, result);
     } else {
-        setup_bvhs<8, 4>(meshes, result);
+        setup_bvhs<8, 4>(ids, meshes, bvh_options, result);
     }
+    result.Timings.BVHBuildMS = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start3).count();
+
+    // Shapes which failed to load are not cached, as the error might be temporary
+    if (ctx.SceneCache.isEnabled() && std::all_of(meshes.begin(), meshes.end(), [](const TriMesh& mesh) { return mesh.faceCount() > 0; }))
+        ctx.SceneCache.storeShapes(cache_key, ctx, result.Database);
 
     return true;
 }
@@ -5,6 +5,18 @@
 namespace IG {
 struct LoaderResult;
 struct LoaderShape {
+    /// Shapes with the same definition share a single mesh and bvh. Only the first shape of each definition is loaded
+    struct Groups {
+        std::vector<std::string> Names;           // All shapes of the scene
+        std::vector<std::string> Representatives; // Representative of each unique shape
+        std::vector<uint32> UniqueIDs;            // Unique shape for each name
+        std::vector<bool> BakeTransform;          // False if the shapes sharing the mesh have different transforms
+    };
+
+    static Groups group(const Parser::Scene& scene);
+    /// Assign the unique shape to each name and the transforms, which have to be applied by the entities
+    static void assign(const Groups& groups, const Parser::Scene& scene, LoaderEnvironment& env);
+
     static bool load(LoaderContext& ctx, LoaderResult& result);
 };
 } // namespace IG
\ No newline at end of file
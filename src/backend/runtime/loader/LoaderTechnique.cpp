@@ -30,10 +30,10 @@ static void ao_body_loader(std::ostream& stream, const std::string&, const std::
 
 /////////////////////////
 
-static void debug_body_loader(std::ostream& stream, const std::string&, const std::shared_ptr<Parser::Object>&, LoaderContext&)
+static void debug_body_loader(std::ostream& stream, const std::string&, const std::shared_ptr<Parser::Object>&, LoaderContext& ctx)
 {
     // TODO: Maybe add a changeable default mode?
-    stream << "  let debug_mode = registry::get_parameter_i32(\"__debug_mode\", 0);" << std::endl
+    stream << "  let debug_mode = registry::get_parameter_i32_by_slot(" << ctx.Parameters->resolveInt("__debug_mode", 0) << ");" << std::endl
            << "  maybe_unused(num_lights); maybe_unused(lights);" << std::endl
            << "  let technique  = make_debug_renderer(debug_mode);" << std::endl;
 }
@@ -69,6 +69,31 @@ static TechniqueInfo wireframe_get_info(const std::string&, const std::shared_pt
 
 /////////////////////////
 
+// Selects the light selector given by the 'light_selector' property. Available are 'uniform', 'power' (default) and 'tree'
+static void light_selector_loader(std::ostream& stream, const std::shared_ptr<Parser::Object>& technique, LoaderContext& ctx)
+{
+    const bool useUniformLS    = technique ? technique->property("use_uniform_light_selector").getBool(false) : false; // Deprecated, use 'light_selector' instead
+    const std::string selector = technique ? to_lowercase(technique->property("light_selector").getString("power")) : std::string("power");
+
+    if (useUniformLS || selector == "uniform" || ctx.Scene.lights().size() <= 1) {
+        stream << "  let light_selector = make_uniform_light_selector(num_lights);" << std::endl;
+    } else if (selector == "tree") {
+        const auto info = ctx.Lights->generateLightTree(ctx);
+        stream << "  let light_selector = make_light_tree_selector(num_lights, " << info.NodeCount << ", " << info.InfiniteCount << ", " << std::to_string(info.InfiniteProbability) << ", device);" << std::endl;
+    } else {
+        if (selector != "power")
+            IG_LOG(L_WARNING) << "Unknown light selector '" << selector << "'. Using 'power' instead" << std::endl;
+
+        auto light_cdf = ctx.Lights->generateLightSelectionCDF(ctx);
+        if (light_cdf.empty()) {
+            stream << "  let light_selector = make_null_light_selector();" << std::endl;
+        } else {
+            stream << "  let light_cdf = cdf::make_cdf_1d_from_buffer(device.load_buffer(\"" << light_cdf.u8string() << "\"), num_lights, 0);" << std::endl
+                   << "  let light_selector = make_cdf_light_selector(light_cdf);" << std::endl;
+        }
+    }
+}
+
 static TechniqueInfo path_get_info(const std::string&, const std::shared_ptr<Parser::Object>& technique, const LoaderContext&)
 {
     TechniqueInfo info;
@@ -95,7 +120,6 @@ static void path_body_loader(std::ostream& stream, const std::string&, const std
 {
     const int max_depth     = technique ? technique->property("max_depth").getInteger(64) : 64;
     const float clamp_value = technique ? technique->property("clamp").getNumber(0) : 0; // Allow clamping of contributions
-    const bool useUniformLS = technique ? technique->property("use_uniform_light_selector").getBool(false) : false;
     const bool hasNormalAOV = technique ? technique->property("aov_normals").getBool(false) : false;
     const bool hasMISAOV    = technique ? technique->property("aov_mis").getBool(false) : false;
 
@@ -125,17 +149,7 @@ static void path_body_loader(std::ostream& stream, const std::string&, const std
            << "    }" << std::endl
            << "  };" << std::endl;
 
-    if (useUniformLS || ctx.Scene.lights().size() <= 1) {
-        stream << "  let light_selector = make_uniform_light_selector(num_lights);" << std::endl;
-    } else {
-        auto light_cdf = ctx.Lights->generateLightSelectionCDF(ctx);
-        if (light_cdf.empty()) {
-            stream << "  let light_selector = make_null_light_selector();" << std::endl;
-        } else {
-            stream << "  let light_cdf = cdf::make_cdf_1d_from_buffer(device.load_buffer(\"" << light_cdf.u8string() << "\"), num_lights, 0);" << std::endl
-                   << "  let light_selector = make_cdf_light_selector(light_cdf);" << std::endl;
-        }
-    }
+    light_selector_loader(stream, technique, ctx);
 
     stream << "  let technique = make_path_renderer(" << max_depth << ", num_lights, lights, light_selector, aovs, " << clamp_value << ");" << std::endl;
 }
@@ -162,19 +176,8 @@ static void volpath_body_loader(std::ostream& stream, const std::string&, const
 {
     const int max_depth     = technique ? technique->property("max_depth").getInteger(64) : 64;
     const float clamp_value = technique ? technique->property("clamp").getNumber(0) : 0; // Allow clamping of contributions
-    const bool useUniformLS = technique ? technique->property("use_uniform_light_selector").getBool(false) : false;
 
-    if (useUniformLS || ctx.Scene.lights().size() <= 1) {
-        stream << "  let light_selector = make_uniform_light_selector(num_lights);" << std::endl;
-    } else {
-        auto light_cdf = ctx.Lights->generateLightSelectionCDF(ctx);
-        if (light_cdf.empty()) {
-            stream << "  let light_selector = make_null_light_selector();" << std::endl;
-        } else {
-            stream << "  let light_cdf = cdf::make_cdf_1d_from_buffer(device.load_buffer(\"" << light_cdf.u8string() << "\"), num_lights, 0);" << std::endl
-                   << "  let light_selector = make_cdf_light_selector(light_cdf);" << std::endl;
-        }
-    }
+    light_selector_loader(stream, technique, ctx);
 
     stream << "  let aovs = @|_id:i32| make_empty_aov_image();" << std::endl;
     stream << "  let technique = make_volume_path_renderer(" << max_depth << ", num_lights, lights, light_selector, media, aovs, " << clamp_value << ");" << std::endl;
@@ -188,88 +188,93 @@ Eigen::Matrix<typename Derived1::Scalar, 3, 4> lookAt(const Eigen::MatrixBase<De
     return m;
 }
 
+inline static Transformf getTransform(const rapidjson::Value& obj)
+{
+    if (obj.IsObject()) {
+        Transformf transform = Transformf::Identity();
+
+        // From left to right. The last entry will be applied first to a potential point A1*A2*A3*...*An*p
+        for (auto val = obj.MemberBegin(); val != obj.MemberEnd(); ++val) {
+            if (val->name == "translate") {
+                const Vector3f pos = getVector3f(val->value, true);
+                transform.translate(pos);
+            } else if (val->name == "scale") {
+                if (val->value.IsNumber()) {
+                    transform.scale(val->value.GetFloat());
+                } else {
+                    const Vector3f s = getVector3f(val->value, true);
+                    transform.scale(s);
+                }
+            } else if (val->name == "rotate") { // [Rotation around X, Rotation around Y, Rotation around Z] all in degrees
+                const Vector3f angles = getVector3f(val->value, true);
+                transform *= Eigen::AngleAxisf(Deg2Rad * angles(0), Vector3f::UnitX())
+                             * Eigen::AngleAxisf(Deg2Rad * angles(1), Vector3f::UnitY())
+                             * Eigen::AngleAxisf(Deg2Rad * angles(2), Vector3f::UnitZ());
+            } else if (val->name == "qrotate") { // 4D Vector quaternion
+                transform *= getQuaternionf(val->value);
+            } else if (val->name == "lookat") {
+                if (val->value.IsObject()) {
+                    Vector3f origin = Vector3f::Zero();
+                    Vector3f target = Vector3f::UnitY();
+                    Vector3f up     = Vector3f::UnitZ();
+
+                    std::optional<Vector3f> direction;
+                    for (auto val2 = val->value.MemberBegin(); val2 != val->value.MemberEnd(); ++val2) {
+                        if (val2->name == "origin")
+                            origin = getVector3f(val2->value);
+                        else if (val2->name == "target")
+                            target = getVector3f(val2->value);
+                        else if (val2->name == "up")
+                            up = getVector3f(val2->value);
+                        else if (val2->name == "direction") // You might give the direction instead of the target
+                            direction = getVector3f(val2->value);
+                    }
+
+                    if (direction.has_value())
+                        transform *= lookAt(origin, direction.value() + origin, up);
+                    else
+                        transform *= lookAt(origin, target, up);
+                } else
+                    throw std::runtime_error("Expected transform lookat property to be an object with origin, target and optional up vector");
+            } else if (val->name == "matrix") {
+                const size_t len = val->value.GetArray().Size();
+                if (len == 9)
+                    transform = transform * Transformf(getMatrix3f(val->value));
+                else if (len == 12 || len == 16)
+                    transform = transform * Transformf(getMatrix4f(val->value));
+                else
+                    throw std::runtime_error("Expected transform property to be an array of size 9 or 16");
+            } else {
+                throw std::runtime_error("Transform property got unknown entry type '" + std::string(val->name.GetString()) + "'");
+            }
+        }
+        return transform;
+    } else if (obj.IsArray()) {
+        const size_t len = obj.GetArray().Size();
+        if (len == 0)
+            return Transformf::Identity();
+        else if (len == 9)
+            return Transformf(getMatrix3f(obj));
+        else if (len == 12 || len == 16)
+            return Transformf(getMatrix4f(obj));
+        else
+            throw std::runtime_error("Expected transform property to be an array of size 9 or 16");
+    } else {
+        throw std::runtime_error("Expected transform property to be an object");
+    }
+}
+
 inline static void populateObject(std::shared_ptr<Object>& ptr, const rapidjson::Value& obj)
 {
     for (auto itr = obj.MemberBegin(); itr != obj.MemberEnd(); ++itr) {
         const std::string name = getString(itr->name);
 
-        // Skip name and type entries
-        if (name == "name" || name == "type")
+        // Skip name and type entries. Instances are expanded by the entity handler
+        if (name == "name" || name == "type" || name == "instances")
             continue;
 
         if (name == "transform") {
-            if (itr->value.IsObject()) {
-                Transformf transform = Transformf::Identity();
-
-                // From left to right. The last entry will be applied first to a potential point A1*A2*A3*...*An*p
-                for (auto val = itr->value.MemberBegin(); val != itr->value.MemberEnd(); ++val) {
-                    if (val->name == "translate") {
-                        const Vector3f pos = getVector3f(val->value, true);
-                        transform.translate(pos);
-                    } else if (val->name == "scale") {
-                        if (val->value.IsNumber()) {
-                            transform.scale(val->value.GetFloat());
-                        } else {
-                            const Vector3f s = getVector3f(val->value, true);
-                            transform.scale(s);
-                        }
-                    } else if (val->name == "rotate") { // [Rotation around X, Rotation around Y, Rotation around Z] all in degrees
-                        const Vector3f angles = getVector3f(val->value, true);
-                        transform *= Eigen::AngleAxisf(Deg2Rad * angles(0), Vector3f::UnitX())
-                                     * Eigen::AngleAxisf(Deg2Rad * angles(1), Vector3f::UnitY())
-                                     * Eigen::AngleAxisf(Deg2Rad * angles(2), Vector3f::UnitZ());
-                    } else if (val->name == "qrotate") { // 4D Vector quaternion
-                        transform *= getQuaternionf(val->value);
-                    } else if (val->name == "lookat") {
-                        if (val->value.IsObject()) {
-                            Vector3f origin = Vector3f::Zero();
-                            Vector3f target = Vector3f::UnitY();
-                            Vector3f up     = Vector3f::UnitZ();
-
-                            std::optional<Vector3f> direction;
-                            for (auto val2 = val->value.MemberBegin(); val2 != val->value.MemberEnd(); ++val2) {
-                                if (val2->name == "origin")
-                                    origin = getVector3f(val2->value);
-                                else if (val2->name == "target")
-                                    target = getVector3f(val2->value);
-                                else if (val2->name == "up")
-                                    up = getVector3f(val2->value);
-                                else if (val2->name == "direction") // You might give the direction instead of the target
-                                    direction = getVector3f(val2->value);
-                            }
-
-                            if (direction.has_value())
-                                transform *= lookAt(origin, direction.value() + origin, up);
-                            else
-                                transform *= lookAt(origin, target, up);
-                        } else
-                            throw std::runtime_error("Expected transform lookat property to be an object with origin, target and optional up vector");
-                    } else if (val->name == "matrix") {
-                        const size_t len = val->value.GetArray().Size();
-                        if (len == 9)
-                            transform = transform * Transformf(getMatrix3f(val->value));
-                        else if (len == 12 || len == 16)
-                            transform = transform * Transformf(getMatrix4f(val->value));
-                        else
-                            throw std::runtime_error("Expected transform property to be an array of size 9 or 16");
-                    } else {
-                        throw std::runtime_error("Transform property got unknown entry type '" + std::string(val->name.GetString()) + "'");
-                    }
-                }
-                ptr->setProperty(name, Property::fromTransform(transform));
-            } else if (itr->value.IsArray()) {
-                const size_t len = itr->value.GetArray().Size();
-                if (len == 0)
-                    ptr->setProperty(name, Property::fromTransform(Transformf::Identity()));
-                else if (len == 9)
-                    ptr->setProperty(name, Property::fromTransform(Transformf(getMatrix3f(itr->value))));
-                else if (len == 12 || len == 16)
-                    ptr->setProperty(name, Property::fromTransform(Transformf(getMatrix4f(itr->value))));
-                else
-                    throw std::runtime_error("Expected transform property to be an array of size 9 or 16");
-            } else {
-                throw std::runtime_error("Expected transform property to be an object");
-            }
+            ptr->setProperty(name, Property::fromTransform(getTransform(itr->value)));
         } else {
             const auto prop = getProperty(itr->value);
             if (prop.isValid())
@@ -334,6 +339,51 @@ static void handleNamedObject(Scene& scene, ObjectType type, const std::filesyst
     }
 }
 
+// An entity with an "instances" array is expanded to one entity per given transform, all sharing the same shape, bsdf and media.
+// Entities with a name already in use, including the expanded names, are ignored
+static void handleEntity(Scene& scene, const std::filesystem::path& baseDir, const rapidjson::Value& obj)
+{
+    if (!obj.HasMember("instances")) {
+        if (obj.HasMember("name") && obj["name"].IsString() && scene.entity(getString(obj["name"]))) {
+            IG_LOG(L_ERROR) << "Ignoring entity '" << getString(obj["name"]) << "' as an entity with the same name already exists" << std::endl;
+            return;
+        }
+
+        handleNamedObject(scene, OT_ENTITY, baseDir, obj);
+        return;
+    }
+
+    if (!obj["instances"].IsArray())
+        throw std::runtime_error("Expected instances to be an array of transforms");
+
+    if (!obj.HasMember("name"))
+        throw std::runtime_error("Expected name");
+
+    if (!obj["name"].IsString())
+        throw std::runtime_error("Expected name to be a string");
+
+    const auto name = getString(obj["name"]);
+
+    auto base = std::make_shared<Object>(OT_ENTITY, "", baseDir);
+    populateObject(base, obj);
+
+    // The transform of the entity itself is applied before the transform of the instance
+    const Transformf transform = base->property("transform").getTransform();
+
+    size_t counter = 0;
+    for (const auto& instance : obj["instances"].GetArray()) {
+        const std::string instanceName = name + "_" + std::to_string(counter++);
+        if (scene.entity(instanceName)) {
+            IG_LOG(L_ERROR) << "Ignoring instance '" << instanceName << "' of entity '" << name << "' as an entity with the same name already exists" << std::endl;
+            continue;
+        }
+
+        auto ptr = std::make_shared<Object>(*base);
+        ptr->setProperty("transform", Property::fromTransform(getTransform(instance) * transform));
+        scene.addEntity(instanceName, ptr);
+    }
+}
+
 static void handleExternalObject(SceneParser& loader, Scene& scene, const std::filesystem::path& baseDir, const rapidjson::Value& obj)
 {
     if (obj.HasMember("type") && !obj["type"].IsString())
@@ -501,7 +551,7 @@ public:
             for (const auto& entity : doc["entities"].GetArray()) {
                 if (!entity.IsObject())
                     throw std::runtime_error("Expected entity element to be an object");
-                handleNamedObject(scene, OT_ENTITY, baseDir, entity);
+                handleEntity(scene, baseDir, entity);
             }
         }
 
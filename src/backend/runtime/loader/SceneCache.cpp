@@ -0,0 +1,405 @@
+#include "SceneCache.h"
+#include "LoaderContext.h"
+#include "Logger.h"
+#include "config/Build.h"
+#include "serialization/FileSerializer.h"
+#include "serialization/HashSerializer.h"
+#include "serialization/MappedFile.h"
+#include "serialization/MemorySerializer.h"
+#include "table/SceneDatabase.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#ifdef IG_OS_WINDOWS
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace IG {
+constexpr uint32 SceneCacheMagic   = 0x43534749; // 'IGSC'
+constexpr uint32 SceneCacheVersion = 3;
+
+// Alignment of tables inside an entry, such that they can be used directly from the mapped file
+constexpr size_t TableAlignment = 64;
+
+// Every entry is given by [magic][version][key] payload [size][magic]. The trailer allows to detect truncated files
+constexpr size_t EntryHeaderSize  = 2 * sizeof(uint32) + sizeof(uint64);
+constexpr size_t EntryTrailerSize = sizeof(uint64) + sizeof(uint32);
+
+static inline uint64 currentProcessId()
+{
+#ifdef IG_OS_WINDOWS
+    return (uint64)_getpid();
+#else
+    return (uint64)getpid();
+#endif
+}
+
+template <typename Func>
+static bool writeEntry(const std::filesystem::path& path, uint64 key, Func func)
+{
+    // Write to a temporary file first, such that other processes never see incomplete entries.
+    // The name is unique for each process and thread, as multiple writers of the same entry are possible
+    std::stringstream suffix;
+    suffix << "." << currentProcessId() << "." << std::hash<std::thread::id>{}(std::this_thread::get_id()) << ".tmp";
+    auto tmp_path = path;
+    tmp_path += suffix.str();
+
+    {
+        FileSerializer serializer(tmp_path, false);
+        if (!serializer.isValid()) {
+            IG_LOG(L_WARNING) << "Could not write scene cache entry " << tmp_path << std::endl;
+            return false;
+        }
+
+        serializer.write(SceneCacheMagic);
+        serializer.write(SceneCacheVersion);
+        serializer.write(key);
+        func(serializer);
+        serializer.write((uint64)(serializer.memoryFootprint() + EntryTrailerSize));
+        serializer.write(SceneCacheMagic);
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        IG_LOG(L_WARNING) << "Could not store scene cache entry " << path << ": " << ec.message() << std::endl;
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+template <typename Func>
+static bool readEntry(const std::filesystem::path& path, uint64 key, Func func)
+{
+    // The file is shared with all tables referencing it and stays mapped as long as one of them exists
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path))
+        return false;
+
+    if (file->size() < EntryHeaderSize + EntryTrailerSize)
+        return false;
+
+    uint64 size  = 0;
+    uint32 magic = 0;
+    std::memcpy(&size, file->data() + file->size() - EntryTrailerSize, sizeof(size));
+    std::memcpy(&magic, file->data() + file->size() - sizeof(magic), sizeof(magic));
+    if (magic != SceneCacheMagic || size != file->size()) {
+        IG_LOG(L_WARNING) << "Ignoring incomplete scene cache entry " << path << std::endl;
+        return false;
+    }
+
+    MemorySerializer serializer(const_cast<uint8*>(file->data()), file->size() - EntryTrailerSize, true);
+
+    uint32 version   = 0;
+    uint64 entry_key = 0;
+    serializer.read(magic);
+    serializer.read(version);
+    serializer.read(entry_key);
+    if (magic != SceneCacheMagic || version != SceneCacheVersion || entry_key != key)
+        return false;
+
+    return func(serializer, file);
+}
+
+static inline size_t alignOffset(size_t offset, size_t alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+static void writePadding(Serializer& serializer, size_t alignment)
+{
+    const size_t defect = alignOffset(serializer.currentSize(), alignment) - serializer.currentSize();
+    for (size_t i = 0; i < defect; ++i)
+        serializer.write((uint8)0);
+}
+
+// A table is given by [count][size] followed by the lookup entries and the data, each aligned relative to the start of the file
+static void writeTable(Serializer& serializer, const DynTable& table)
+{
+    serializer.write((uint64)table.entryCount());
+    serializer.write((uint64)table.dataSize());
+    writePadding(serializer, TableAlignment);
+    serializer.writeRaw(reinterpret_cast<const uint8*>(table.lookupPtr()), table.entryCount() * sizeof(LookupEntry));
+    writePadding(serializer, TableAlignment);
+    serializer.writeRaw(table.dataPtr(), table.dataSize());
+}
+
+// The table references the mapped file directly, which prevents any copy on the host and allows multiple processes to share the same physical pages
+static bool mapTable(MemorySerializer& serializer, const std::shared_ptr<MappedFile>& file, DynTable& table)
+{
+    uint64 count = 0;
+    uint64 size  = 0;
+    serializer.read(count);
+    serializer.read(size);
+
+    const size_t lookupOffset = alignOffset(serializer.position(), TableAlignment);
+    if (count > (serializer.maxSize() - std::min(lookupOffset, serializer.maxSize())) / sizeof(LookupEntry))
+        return false;
+
+    const size_t dataOffset = alignOffset(lookupOffset + count * sizeof(LookupEntry), TableAlignment);
+    if (dataOffset > serializer.maxSize() || size > serializer.maxSize() - dataOffset)
+        return false;
+
+    table.assignExternal(file, reinterpret_cast<const LookupEntry*>(file->data() + lookupOffset), count, file->data() + dataOffset, size);
+    serializer.seek(dataOffset + size);
+    return true;
+}
+
+static void hashObject(Serializer& hasher, const Parser::Object& obj, const LoaderContext& ctx)
+{
+    hasher.write(obj.pluginType());
+
+    // The properties are stored in an unordered map, which has no stable order
+    std::vector<std::string> keys;
+    keys.reserve(obj.properties().size());
+    for (const auto& pair : obj.properties())
+        keys.push_back(pair.first);
+    std::sort(keys.begin(), keys.end());
+
+    for (const auto& key : keys) {
+        const auto prop = obj.property(key);
+        hasher.write(key);
+        hasher.write((uint32)prop.type());
+        switch (prop.type()) {
+        case Parser::PT_NONE:
+            break;
+        case Parser::PT_BOOL:
+            hasher.write(prop.getBool());
+            break;
+        case Parser::PT_INTEGER:
+            hasher.write(prop.getInteger());
+            break;
+        case Parser::PT_NUMBER:
+            hasher.write(prop.getNumber());
+            break;
+        case Parser::PT_STRING:
+            hasher.write(prop.getString());
+            break;
+        case Parser::PT_TRANSFORM:
+            hasher.write(prop.getTransform().matrix());
+            break;
+        case Parser::PT_VECTOR2:
+            hasher.write(prop.getVector2());
+            break;
+        case Parser::PT_VECTOR3:
+            hasher.write(prop.getVector3());
+            break;
+        }
+    }
+
+    // Changes to referenced files are detected by their size and modification time only, as hashing the content would be as expensive as loading it
+    const auto filename = obj.property("filename");
+    if (filename.type() == Parser::PT_STRING) {
+        const auto path = ctx.handlePath(filename.getString(), obj);
+
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(path, ec);
+        const auto time = std::filesystem::last_write_time(path, ec);
+        hasher.write(path.generic_u8string());
+        hasher.write((uint64)size);
+        hasher.write((int64)time.time_since_epoch().count());
+    }
+}
+
+SceneCache::SceneCache(const std::filesystem::path& root, Target target)
+{
+    if (root.empty())
+        return;
+
+    std::error_code ec;
+    const auto dir = root / targetToString(target);
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+        IG_LOG(L_WARNING) << "Could not create scene cache directory " << dir << ": " << ec.message() << ". Disabling scene cache" << std::endl;
+        return;
+    }
+
+    mDirectory = std::filesystem::absolute(dir);
+
+    // The serialized layout might change between builds
+    HashSerializer hasher;
+    hasher.write(SceneCacheVersion);
+    hasher.write(std::string(targetToString(target)));
+    hasher.write(Build::getGitString());
+    mSeed = hasher.hash();
+}
+
+std::filesystem::path SceneCache::entryPath(const char* prefix, uint64 key) const
+{
+    std::stringstream stream;
+    stream << prefix << "_" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return mDirectory / stream.str();
+}
+
+uint64 SceneCache::computeShapeKey(const LoaderContext& ctx) const
+{
+    HashSerializer hasher(mSeed);
+    hasher.write((uint32)ctx.BVHOptions.Builder);
+    hasher.write(ctx.BVHOptions.Reinsertion);
+    hasher.write(ctx.BVHOptions.LayoutOptimization);
+
+    for (const auto& pair : ctx.Scene.shapes()) {
+        hasher.write(pair.first);
+        hashObject(hasher, *pair.second, ctx);
+    }
+
+    return hasher.hash();
+}
+
+bool SceneCache::loadShapes(uint64 key, LoaderContext& ctx, SceneDatabase& database) const
+{
+    if (!isEnabled())
+        return false;
+
+    return readEntry(entryPath("shapes", key), key, [&](MemorySerializer& serializer, const std::shared_ptr<MappedFile>& file) {
+        // Everything is read and mapped first and only applied if the whole entry is valid,
+        // such that a failure leaves the context and database untouched for the regular loading
+        uint64 count = 0;
+        serializer.read(count);
+        if (count > serializer.maxSize() - serializer.position())
+            return false;
+
+        std::vector<Shape> shapes(count);
+        std::unordered_map<uint32, PlaneShape> planeShapes;
+        for (uint64 id = 0; id < count; ++id) {
+            Shape& shape = shapes[id];
+            uint64 vertexCount, normalCount, texCount, faceCount;
+            serializer.read(vertexCount);
+            serializer.read(normalCount);
+            serializer.read(texCount);
+            serializer.read(faceCount);
+            shape.VertexCount = vertexCount;
+            shape.NormalCount = normalCount;
+            shape.TexCount    = texCount;
+            shape.FaceCount   = faceCount;
+            serializer.read(shape.BoundingBox.min);
+            serializer.read(shape.BoundingBox.max);
+            serializer.read(shape.Area);
+
+            bool isPlane = false;
+            serializer.read(isPlane);
+            if (isPlane) {
+                PlaneShape plane;
+                serializer.read(plane.Origin);
+                serializer.read(plane.XAxis);
+                serializer.read(plane.YAxis);
+                for (auto& uv : plane.TexCoords)
+                    serializer.read(uv);
+                planeShapes[(uint32)id] = plane;
+            }
+        }
+
+        // Multiple names might share the same shape
+        uint64 nameCount = 0;
+        serializer.read(nameCount);
+        if (nameCount > serializer.maxSize() - serializer.position())
+            return false;
+
+        std::unordered_map<std::string, uint32> shapeIDs;
+        std::unordered_map<std::string, Transformf> shapeTransforms;
+        for (uint64 i = 0; i < nameCount; ++i) {
+            std::string name;
+            uint32 id         = 0;
+            bool hasTransform = false;
+            serializer.read(name);
+            serializer.read(id);
+            serializer.read(hasTransform);
+            if (id >= count)
+                return false;
+
+            shapeIDs[name] = id;
+            if (hasTransform) {
+                Matrix4f matrix;
+                serializer.read(matrix);
+                shapeTransforms[name] = Transformf(matrix);
+            }
+        }
+
+        DynTable shapeTable;
+        DynTable bvhTable;
+        if (!mapTable(serializer, file, shapeTable) || !mapTable(serializer, file, bvhTable))
+            return false;
+
+        ctx.Environment.Shapes          = std::move(shapes);
+        ctx.Environment.PlaneShapes     = std::move(planeShapes);
+        ctx.Environment.ShapeIDs        = std::move(shapeIDs);
+        ctx.Environment.ShapeTransforms = std::move(shapeTransforms);
+        database.ShapeTable             = std::move(shapeTable);
+        database.BVHTable               = std::move(bvhTable);
+        return true;
+    });
+}
+
+void SceneCache::storeShapes(uint64 key, const LoaderContext& ctx, const SceneDatabase& database) const
+{
+    if (!isEnabled())
+        return;
+
+    writeEntry(entryPath("shapes", key), key, [&](Serializer& serializer) {
+        serializer.write((uint64)ctx.Environment.Shapes.size());
+        for (size_t id = 0; id < ctx.Environment.Shapes.size(); ++id) {
+            const Shape& shape = ctx.Environment.Shapes[id];
+            serializer.write((uint64)shape.VertexCount);
+            serializer.write((uint64)shape.NormalCount);
+            serializer.write((uint64)shape.TexCount);
+            serializer.write((uint64)shape.FaceCount);
+            serializer.write(shape.BoundingBox.min);
+            serializer.write(shape.BoundingBox.max);
+            serializer.write(shape.Area);
+
+            const auto plane = ctx.Environment.PlaneShapes.find((uint32)id);
+            serializer.write(plane != ctx.Environment.PlaneShapes.end());
+            if (plane != ctx.Environment.PlaneShapes.end()) {
+                serializer.write(plane->second.Origin);
+                serializer.write(plane->second.XAxis);
+                serializer.write(plane->second.YAxis);
+                for (const auto& uv : plane->second.TexCoords)
+                    serializer.write(uv);
+            }
+        }
+
+        serializer.write((uint64)ctx.Environment.ShapeIDs.size());
+        for (const auto& pair : ctx.Environment.ShapeIDs) {
+            const auto transform = ctx.Environment.ShapeTransforms.find(pair.first);
+            serializer.write(pair.first);
+            serializer.write(pair.second);
+            serializer.write(transform != ctx.Environment.ShapeTransforms.end());
+            if (transform != ctx.Environment.ShapeTransforms.end())
+                serializer.write(transform->second.matrix());
+        }
+
+        writeTable(serializer, database.ShapeTable);
+        writeTable(serializer, database.BVHTable);
+    });
+}
+
+bool SceneCache::loadSceneBVH(uint64 key, SceneBVH& bvh) const
+{
+    if (!isEnabled())
+        return false;
+
+    // The scene bvh is small compared to the shapes and therefore copied
+    return readEntry(entryPath("scene_bvh", key), key, [&](MemorySerializer& serializer, const std::shared_ptr<MappedFile>&) {
+        serializer.read(bvh.Nodes);
+        serializer.read(bvh.Leaves);
+        return true;
+    });
+}
+
+void SceneCache::storeSceneBVH(uint64 key, const SceneBVH& bvh) const
+{
+    if (!isEnabled())
+        return;
+
+    writeEntry(entryPath("scene_bvh", key), key, [&](Serializer& serializer) {
+        serializer.write(bvh.Nodes);
+        serializer.write(bvh.Leaves);
+    });
+}
+} // namespace IG
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Target.h"
+
+namespace IG {
+struct LoaderContext;
+struct SceneBVH;
+struct SceneDatabase;
+
+/// Persistent on-disk cache of the already serialized shape and bvh tables, as well as the scene bvh.
+/// Entries are stored in a target specific subdirectory, as the bvh layout depends on the target
+class SceneCache {
+public:
+    SceneCache() = default;
+    SceneCache(const std::filesystem::path& root, Target target);
+
+    inline bool isEnabled() const { return !mDirectory.empty(); }
+
+    /// The target specific directory containing all the cached data
+    inline const std::filesystem::path& directory() const { return mDirectory; }
+
+    /// Key based on the description of all shapes, the size and modification time of referenced files and the bvh options
+    uint64 computeShapeKey(const LoaderContext& ctx) const;
+    /// Seed for custom keys computed with a HashSerializer. It depends on the target and the build
+    inline uint64 seed() const { return mSeed; }
+
+    /// Restore shape information in the environment and the shape and bvh tables. Returns false if the entry is not available.
+    /// The tables are not copied, but reference the mapped entry directly
+    bool loadShapes(uint64 key, LoaderContext& ctx, SceneDatabase& database) const;
+    void storeShapes(uint64 key, const LoaderContext& ctx, const SceneDatabase& database) const;
+
+    bool loadSceneBVH(uint64 key, SceneBVH& bvh) const;
+    void storeSceneBVH(uint64 key, const SceneBVH& bvh) const;
+
+private:
+    std::filesystem::path entryPath(const char* prefix, uint64 key) const;
+
+    std::filesystem::path mDirectory;
+    uint64 mSeed = 0;
+};
+} // namespace IG
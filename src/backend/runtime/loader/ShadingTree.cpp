@@ -7,6 +7,7 @@
 namespace IG {
 ShadingTree::ShadingTree(LoaderContext& ctx)
     : mContext(ctx)
+    , mLoadedParameterTable(false)
     , mTranspiler(ctx)
 {
     beginClosure();
@@ -34,15 +35,15 @@ void ShadingTree::addNumber(const std::string& name, const Parser::Object& obj,
     case Parser::PT_NONE:
         if (!hasDef)
             return;
-        inline_str = std::to_string(def);
+        inline_str = acquireNumber(name, obj, def);
         break;
     case Parser::PT_INTEGER:
     case Parser::PT_NUMBER:
-        inline_str = std::to_string(prop.getNumber());
+        inline_str = acquireNumber(name, obj, prop.getNumber());
         break;
     case Parser::PT_VECTOR3:
         IG_LOG(L_WARNING) << "Parameter '" << name << "' expects a number but a color was given. Using average instead" << std::endl;
-        inline_str = std::to_string(prop.getVector3().mean());
+        inline_str = acquireNumber(name, obj, prop.getVector3().mean());
         break;
     case Parser::PT_STRING:
         inline_str = handleTexture(prop.getString(), mode == IM_Bare ? "tex_coords" : "surf.tex_coords", false, mode == IM_Surface);
@@ -69,16 +70,15 @@ void ShadingTree::addColor(const std::string& name, const Parser::Object& obj, c
     case Parser::PT_NONE:
         if (!hasDef)
             return;
-        inline_str = "make_color(" + std::to_string(def.x()) + ", " + std::to_string(def.y()) + ", " + std::to_string(def.z()) + ", 1)";
+        inline_str = acquireColor(name, obj, def);
         break;
     case Parser::PT_INTEGER:
     case Parser::PT_NUMBER:
-        inline_str = "make_gray_color(" + std::to_string(prop.getNumber()) + ")";
+        inline_str = acquireColor(name, obj, Vector3f::Constant(prop.getNumber()));
+        break;
+    case Parser::PT_VECTOR3:
+        inline_str = acquireColor(name, obj, prop.getVector3());
         break;
-    case Parser::PT_VECTOR3: {
-        Vector3f color = prop.getVector3();
-        inline_str     = "make_color(" + std::to_string(color.x()) + ", " + std::to_string(color.y()) + ", " + std::to_string(color.z()) + ", 1)";
-    } break;
     case Parser::PT_STRING:
         inline_str = handleTexture(prop.getString(), mode == IM_Bare ? "tex_coords" : "surf.tex_coords", true, mode == IM_Surface);
         break;
@@ -181,6 +181,61 @@ void ShadingTree::registerTextureUsage(const std::string& name)
     }
 }
 
+std::string ShadingTree::acquireNumber(const std::string& name, const Parser::Object& obj, float number)
+{
+    const auto offset = registerTableParameter(name, obj, Vector3f::Constant(number));
+    if (offset.has_value())
+        return "material_parameters.load_f32(" + std::to_string(offset.value()) + ")";
+    else
+        return std::to_string(number);
+}
+
+std::string ShadingTree::acquireColor(const std::string& name, const Parser::Object& obj, const Vector3f& color)
+{
+    const auto offset = registerTableParameter(name, obj, color);
+    if (offset.has_value())
+        return "vec3_to_color(material_parameters.load_vec3(" + std::to_string(offset.value()) + "))";
+    else if (color.x() == color.y() && color.y() == color.z())
+        return "make_gray_color(" + std::to_string(color.x()) + ")";
+    else
+        return "make_color(" + std::to_string(color.x()) + ", " + std::to_string(color.y()) + ", " + std::to_string(color.z()) + ", 1)";
+}
+
+std::optional<size_t> ShadingTree::registerTableParameter(const std::string& name, const Parser::Object& obj, const Vector3f& value)
+{
+    if (!mContext.UseMaterialParameterTable)
+        return std::nullopt;
+
+    const auto owner = mContext.MaterialParameterOwners.find(&obj);
+    if (owner == mContext.MaterialParameterOwners.end())
+        return std::nullopt;
+
+    // Parameters are shared between all shaders and technique variants
+    const std::string fullName = owner->second + "." + name;
+    auto& parameters           = mContext.Database->MaterialParameters;
+    size_t offset              = 0;
+    if (const auto it = parameters.find(fullName); it != parameters.end()) {
+        offset = it->second;
+    } else {
+        // Every parameter occupies four floats to allow aligned vector loads
+        auto& table = mContext.Database->CustomTables[MaterialParameterTableName];
+        auto& data  = table.entryCount() == 0 ? table.addLookup(0, 0, DefaultAlignment) : table.data(); // We do not make use of the typeid
+        offset      = data.size() / sizeof(float);
+
+        const float entry[4] = { value.x(), value.y(), value.z(), 0.0f };
+        data.insert(data.end(), reinterpret_cast<const uint8*>(entry), reinterpret_cast<const uint8*>(entry) + sizeof(entry));
+        parameters[fullName] = offset;
+    }
+
+    if (!mLoadedParameterTable) {
+        mHeaderLines.push_back(std::string("  let material_parameter_table = device.load_custom_dyntable(\"") + MaterialParameterTableName + "\");\n"
+                               + "  let material_parameters = get_table_entry(0, material_parameter_table, device.get_device_buffer_accessor());\n");
+        mLoadedParameterTable = true;
+    }
+
+    return offset;
+}
+
 std::string ShadingTree::handleTexture(const std::string& expr, const std::string& uv_access, bool needColor, bool hasSurfaceInfo)
 {
     auto res = mTranspiler.transpile(expr, uv_access, hasSurfaceInfo);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Transpiler.h"
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -51,10 +52,16 @@ private:
 
     std::string handleTexture(const std::string& name, const std::string& uv_access, bool needColor, bool hasSurfaceInfo);
 
+    /// Will return an access to the material parameter table if enabled and available for the given object, else the constant is inlined
+    std::string acquireNumber(const std::string& name, const Parser::Object& obj, float number);
+    std::string acquireColor(const std::string& name, const Parser::Object& obj, const Vector3f& color);
+    std::optional<size_t> registerTableParameter(const std::string& name, const Parser::Object& obj, const Vector3f& value);
+
     LoaderContext& mContext;
 
     std::vector<std::string> mHeaderLines; // The order matters
     std::unordered_set<std::string> mLoadedTextures;
+    bool mLoadedParameterTable;
 
     std::vector<Closure> mClosures;
 
@@ -0,0 +1,45 @@
+#include "HashSerializer.h"
+
+namespace IG {
+constexpr uint64 FNVOffsetBasis = 0xcbf29ce484222325ull;
+constexpr uint64 FNVPrime       = 0x100000001b3ull;
+
+HashSerializer::HashSerializer()
+    : HashSerializer(FNVOffsetBasis)
+{
+}
+
+HashSerializer::HashSerializer(uint64 seed)
+    : Serializer(false)
+    , mHash(seed)
+    , mSize(0)
+{
+}
+
+bool HashSerializer::isValid() const
+{
+    return true;
+}
+
+size_t HashSerializer::currentSize() const
+{
+    return mSize;
+}
+
+size_t HashSerializer::writeRaw(const uint8* data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        mHash ^= (uint64)data[i];
+        mHash *= FNVPrime;
+    }
+
+    mSize += size;
+    return size;
+}
+
+size_t HashSerializer::readRaw(uint8*, size_t)
+{
+    IG_ASSERT(false, "Trying to read from a hash serializer!");
+    return 0;
+}
+} // namespace IG
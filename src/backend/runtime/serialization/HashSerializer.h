@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Serializer.h"
+
+namespace IG {
+/// Write-only serializer feeding all data into a FNV-1a hash instead of storing it.
+/// The hash is stable between runs and implementations, which makes it suitable as a key for persistent caches
+class HashSerializer : public Serializer {
+public:
+    HashSerializer();
+    explicit HashSerializer(uint64 seed);
+    virtual ~HashSerializer() = default;
+
+    inline uint64 hash() const { return mHash; }
+
+    // Interface
+    virtual bool isValid() const override;
+    virtual size_t writeRaw(const uint8* data, size_t size) override;
+    virtual size_t readRaw(uint8* data, size_t size) override;
+    virtual size_t currentSize() const override;
+
+private:
+    uint64 mHash;
+    size_t mSize;
+};
+} // namespace IG
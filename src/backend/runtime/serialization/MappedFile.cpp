@@ -0,0 +1,120 @@
+#include "MappedFile.h"
+
+#if defined(IG_OS_LINUX) || defined(IG_OS_APPLE)
+#define USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(IG_OS_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#error Memory mapping implementation missing
+#endif
+
+namespace IG {
+struct MappedFileInternal {
+#ifdef USE_MMAP
+    int File = -1;
+#elif defined(IG_OS_WINDOWS)
+    HANDLE File    = INVALID_HANDLE_VALUE;
+    HANDLE Mapping = NULL;
+#endif
+};
+
+MappedFile::MappedFile()
+    : mData(nullptr)
+    , mSize(0)
+    , mInternal(std::make_unique<MappedFileInternal>())
+{
+}
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+    : MappedFile()
+{
+    open(path);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::filesystem::path& path)
+{
+    if (isValid())
+        return false;
+
+#ifdef USE_MMAP
+    mInternal->File = ::open(path.c_str(), O_RDONLY);
+    if (mInternal->File < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(mInternal->File, &info) != 0 || info.st_size <= 0) {
+        close();
+        return false;
+    }
+
+    void* ptr = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, mInternal->File, 0);
+    if (ptr == MAP_FAILED) {
+        close();
+        return false;
+    }
+
+    mData = reinterpret_cast<const uint8*>(ptr);
+    mSize = (size_t)info.st_size;
+#elif defined(IG_OS_WINDOWS)
+    mInternal->File = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (mInternal->File == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(mInternal->File, &size) || size.QuadPart <= 0) {
+        close();
+        return false;
+    }
+
+    mInternal->Mapping = CreateFileMappingW(mInternal->File, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mInternal->Mapping == NULL) {
+        close();
+        return false;
+    }
+
+    void* ptr = MapViewOfFile(mInternal->Mapping, FILE_MAP_READ, 0, 0, 0);
+    if (ptr == nullptr) {
+        close();
+        return false;
+    }
+
+    mData = reinterpret_cast<const uint8*>(ptr);
+    mSize = (size_t)size.QuadPart;
+#endif
+
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef USE_MMAP
+    if (mData)
+        munmap(const_cast<uint8*>(mData), mSize);
+    if (mInternal->File >= 0)
+        ::close(mInternal->File);
+    mInternal->File = -1;
+#elif defined(IG_OS_WINDOWS)
+    if (mData)
+        UnmapViewOfFile(mData);
+    if (mInternal->Mapping != NULL)
+        CloseHandle(mInternal->Mapping);
+    if (mInternal->File != INVALID_HANDLE_VALUE)
+        CloseHandle(mInternal->File);
+    mInternal->Mapping = NULL;
+    mInternal->File    = INVALID_HANDLE_VALUE;
+#endif
+
+    mData = nullptr;
+    mSize = 0;
+}
+} // namespace IG
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "IG_Config.h"
+
+namespace IG {
+/// Read-only view of a whole file mapped into memory
+class MappedFile {
+    IG_CLASS_NON_COPYABLE(MappedFile);
+    IG_CLASS_NON_MOVEABLE(MappedFile);
+
+public:
+    MappedFile();
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    bool open(const std::filesystem::path& path);
+    void close();
+
+    inline bool isValid() const { return mData != nullptr; }
+    inline const uint8* data() const { return mData; }
+    inline size_t size() const { return mSize; }
+
+private:
+    const uint8* mData;
+    size_t mSize;
+    std::unique_ptr<struct MappedFileInternal> mInternal;
+};
+} // namespace IG
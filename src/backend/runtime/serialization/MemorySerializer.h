@@ -10,6 +10,8 @@ public:
     virtual ~MemorySerializer();
 
     inline size_t maxSize() const { return mSize; }
+    inline size_t position() const { return mIt; }
+    inline void seek(size_t pos) { mIt = std::min(pos, mSize); }
 
     bool open(uint8* buffer, size_t size, bool readmode);
     void close();
@@ -11,18 +11,46 @@
 #include "loader/ShadingTree.h"
 
 #include <sstream>
+#include <unordered_map>
 
 namespace IG {
 using namespace Parser;
 
-std::string HitShader::setup(size_t mat_id, LoaderContext& ctx)
+std::vector<std::vector<size_t>> HitShader::groupMaterials(const LoaderContext& ctx)
+{
+    const auto& materials = ctx.Environment.Materials;
+
+    std::vector<std::vector<size_t>> groups;
+    std::unordered_map<std::string, size_t> emissive_groups; // Non-emissive materials are unique already
+    for (size_t i = 0; i < materials.size(); ++i) {
+        const Material& material = materials[i];
+        if (!material.hasEmission() || !ctx.Lights->isAreaLight(material.Entity)) {
+            groups.push_back({ i });
+            continue;
+        }
+
+        const std::string key = material.BSDF + "|" + std::to_string(material.MediumInner) + "|" + std::to_string(material.MediumOuter);
+        const auto it         = emissive_groups.find(key);
+        if (it == emissive_groups.end()) {
+            emissive_groups[key] = groups.size();
+            groups.push_back({ i });
+        } else {
+            groups[it->second].push_back(i);
+        }
+    }
+
+    return groups;
+}
+
+std::string HitShader::setup(const std::vector<size_t>& mat_ids, LoaderContext& ctx)
 {
     std::stringstream stream;
 
     stream << LoaderTechnique::generateHeader(ctx) << std::endl;
 
-    stream << "#[export] fn ig_hit_shader(settings: &Settings, entity_id: i32, first: i32, last: i32) -> () {" << std::endl
+    stream << "#[export] fn ig_hit_shader(settings: &Settings, entity_id: i32, material_id: i32, first: i32, last: i32) -> () {" << std::endl
            << "  maybe_unused(settings);" << std::endl
+           << "  maybe_unused(material_id);" << std::endl
            << "  " << ShaderUtils::constructDevice(ctx.Target) << std::endl
            << std::endl;
 
@@ -50,7 +78,7 @@ std::string HitShader::setup(size_t mat_id, LoaderContext& ctx)
            << "  };" << std::endl
            << std::endl;
 
-    stream << ShaderUtils::generateMaterialShader(tree, mat_id, requireLights, "shader") << std::endl;
+    stream << ShaderUtils::generateMaterialShader(tree, mat_ids, requireLights, "shader", "material_id") << std::endl;
 
     // Include camera if necessary
     if (ctx.CurrentTechniqueVariantInfo().RequiresExplicitCamera)
@@ -62,8 +90,12 @@ std::string HitShader::setup(size_t mat_id, LoaderContext& ctx)
     stream << LoaderTechnique::generate(ctx) << std::endl
            << std::endl;
 
-    stream << "  let use_framebuffer = " << (!ctx.CurrentTechniqueVariantInfo().LockFramebuffer ? "true" : "false") << ";" << std::endl
-           << "  device.handle_hit_shader(entity_id, shader, scene, technique, first, last, spi, use_framebuffer);" << std::endl
+    // If sorted by material, the range contains multiple entities and each ray carries its own one. The constant is required to specialize the shader
+    const char* entity_id_str = ctx.SortPrimaryByMaterial ? "-1" : "entity_id";
+
+    stream << "  maybe_unused(entity_id);" << std::endl
+           << "  let use_framebuffer = " << (!ctx.CurrentTechniqueVariantInfo().LockFramebuffer ? "true" : "false") << ";" << std::endl
+           << "  device.handle_hit_shader(" << entity_id_str << ", shader, scene, technique, first, last, spi, use_framebuffer);" << std::endl
            << "}" << std::endl;
 
     return stream.str();
@@ -4,6 +4,11 @@
 
 namespace IG {
 struct HitShader {
-    static std::string setup(size_t mat_id, LoaderContext& ctx);
+    /// Groups materials which would result in hit shaders only differing in their material id and associated area light.
+    /// This is the case for area lights sharing the same bsdf and medium interface
+    static std::vector<std::vector<size_t>> groupMaterials(const LoaderContext& ctx);
+
+    /// Generates a single hit shader for all the given materials
+    static std::string setup(const std::vector<size_t>& mat_ids, LoaderContext& ctx);
 };
 } // namespace IG
\ No newline at end of file
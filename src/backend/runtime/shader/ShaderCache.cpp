@@ -0,0 +1,78 @@
+#include "ShaderCache.h"
+#include "Logger.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace IG {
+// Simple FNV-1a hash. std::hash is not guaranteed to be stable between runs or implementations
+constexpr uint64 FNVOffsetBasis = 0xcbf29ce484222325ull;
+constexpr uint64 FNVPrime       = 0x100000001b3ull;
+static inline uint64 fnv1a(const std::string_view& str, uint64 hash = FNVOffsetBasis)
+{
+    for (const char c : str) {
+        hash ^= (uint64)(uint8)c;
+        hash *= FNVPrime;
+    }
+    return hash;
+}
+
+ShaderCache::ShaderCache(const std::filesystem::path& root, Target target, uint32 driverMajor, uint32 driverMinor)
+{
+    if (root.empty())
+        return;
+
+    const std::string driver = std::string(targetToString(target)) + "_v" + std::to_string(driverMajor) + "." + std::to_string(driverMinor);
+
+    std::error_code ec;
+    const auto dir = root / driver;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+        IG_LOG(L_WARNING) << "Could not create shader cache directory " << dir << ": " << ec.message() << ". Disabling shader cache" << std::endl;
+        return;
+    }
+
+    mDirectory = std::filesystem::absolute(dir);
+    mSeed      = fnv1a(driver);
+}
+
+uint64 ShaderCache::computeKey(const std::string_view& src) const
+{
+    return fnv1a(src, mSeed);
+}
+
+std::filesystem::path ShaderCache::entryPath(uint64 key) const
+{
+    std::stringstream stream;
+    stream << std::hex << std::setw(16) << std::setfill('0') << key << ".ig";
+    return mDirectory / stream.str();
+}
+
+bool ShaderCache::has(uint64 key, const std::string_view& src) const
+{
+    if (!isEnabled())
+        return false;
+
+    std::ifstream stream(entryPath(key));
+
+    size_t size = 0;
+    bool found  = stream.good() && (stream >> size) && size == src.size();
+
+    std::lock_guard<std::mutex> _guard(mMutex);
+    if (found)
+        ++mFoundMarkers;
+    else
+        ++mMissingMarkers;
+    return found;
+}
+
+void ShaderCache::store(uint64 key, const std::string_view& src)
+{
+    if (!isEnabled())
+        return;
+
+    std::ofstream stream(entryPath(key));
+    stream << src.size();
+}
+} // namespace IG
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Target.h"
+
+#include <mutex>
+
+namespace IG {
+/// Content addressed bookkeeping of shaders already compiled by the jit.
+/// The actual compiled modules are stored by the AnyDSL runtime inside directory().
+/// A marker file is written for each compiled shader. The AnyDSL runtime does not report if a module was loaded from its cache,
+/// therefore only the found and missing markers are counted, which tell if a shader was compiled before
+class ShaderCache {
+public:
+    ShaderCache() = default;
+    ShaderCache(const std::filesystem::path& root, Target target, uint32 driverMajor, uint32 driverMinor);
+
+    inline bool isEnabled() const { return !mDirectory.empty(); }
+
+    /// The target and driver specific directory containing all the cached data
+    inline const std::filesystem::path& directory() const { return mDirectory; }
+
+    /// Key based on the full preprocessed source, the target and the driver version
+    uint64 computeKey(const std::string_view& src) const;
+
+    /// Returns true if a shader with the given key and source was compiled and stored before
+    bool has(uint64 key, const std::string_view& src) const;
+    /// Mark the shader with the given key as compiled and stored
+    void store(uint64 key, const std::string_view& src);
+
+    /// Number of lookups which found a marker of a previously compiled shader
+    inline size_t foundMarkerCount() const { return mFoundMarkers; }
+    /// Number of lookups which found no marker
+    inline size_t missingMarkerCount() const { return mMissingMarkers; }
+
+private:
+    std::filesystem::path entryPath(uint64 key) const;
+
+    std::filesystem::path mDirectory;
+    uint64 mSeed = 0;
+
+    mutable std::mutex mMutex;
+    mutable size_t mFoundMarkers   = 0;
+    mutable size_t mMissingMarkers = 0;
+};
+} // namespace IG
@@ -53,25 +53,65 @@ std::string ShaderUtils::generateDatabase()
 
 std::string ShaderUtils::generateMaterialShader(ShadingTree& tree, size_t mat_id, bool requireLights, const std::string_view& output_var)
 {
+    return generateMaterialShader(tree, std::vector<size_t>{ mat_id }, requireLights, output_var, {});
+}
+
+std::string ShaderUtils::generateMaterialShader(ShadingTree& tree, const std::vector<size_t>& mat_ids, bool requireLights, const std::string_view& output_var, const std::string_view& mat_id_var)
+{
+    IG_ASSERT(!mat_ids.empty(), "Expected at least one material");
+    IG_ASSERT(mat_ids.size() == 1 || !mat_id_var.empty(), "Expected a material id variable for shared material shaders");
+
     std::stringstream stream;
 
-    const Material material = tree.context().Environment.Materials.at(mat_id);
+    const Material material = tree.context().Environment.Materials.at(mat_ids.front());
     stream << LoaderBSDF::generate(material.BSDF, tree);
 
     const bool isLight = material.hasEmission() && tree.context().Lights->isAreaLight(material.Entity) > 0;
 
+    // Shared shaders get the material id at runtime, single ones have it inlined
+    std::string mat_id_str;
+    if (mat_ids.size() == 1)
+        mat_id_str = std::to_string(mat_ids.front());
+    else
+        mat_id_str = mat_id_var;
+
     if (material.hasMediumInterface())
         stream << "  let medium_interface = make_medium_interface(" << material.MediumInner << ", " << material.MediumOuter << ");" << std::endl;
     else
         stream << "  let medium_interface = no_medium_interface();" << std::endl;
 
     if (isLight && requireLights) {
-        const uint32 light_id = tree.context().Lights->getAreaLightID(material.Entity);
-        stream << "  let " << output_var << " : Shader = @|ray, hit, surf| make_emissive_material(" << mat_id << ", surf, bsdf_" << LoaderUtils::escapeIdentifier(material.BSDF) << "(ray, hit, surf), medium_interface,"
-               << " @lights(" << light_id << "));" << std::endl
+        std::string light_id_str;
+        if (mat_ids.size() == 1) {
+            light_id_str = std::to_string(tree.context().Lights->getAreaLightID(material.Entity));
+        } else {
+            // Use a simple offset if possible, else map the material id to the associated area light
+            std::vector<int64> light_ids;
+            light_ids.reserve(mat_ids.size());
+            bool sameOffset = true;
+            for (size_t mat_id : mat_ids) {
+                light_ids.push_back((int64)tree.context().Lights->getAreaLightID(tree.context().Environment.Materials.at(mat_id).Entity));
+                sameOffset = sameOffset && (light_ids.back() - (int64)mat_id) == (light_ids.front() - (int64)mat_ids.front());
+            }
+
+            if (sameOffset) {
+                const int64 offset = light_ids.front() - (int64)mat_ids.front();
+                light_id_str       = mat_id_str + (offset < 0 ? " - " : " + ") + std::to_string(std::abs(offset));
+            } else {
+                stream << "  let light_id = match(" << mat_id_str << ") {" << std::endl;
+                for (size_t i = 1; i < mat_ids.size(); ++i)
+                    stream << "    " << mat_ids[i] << " => " << light_ids[i] << "," << std::endl;
+                stream << "    _ => " << light_ids.front() << std::endl
+                       << "  };" << std::endl;
+                light_id_str = "light_id";
+            }
+        }
+
+        stream << "  let " << output_var << " : Shader = @|ray, hit, surf| make_emissive_material(" << mat_id_str << ", surf, bsdf_" << LoaderUtils::escapeIdentifier(material.BSDF) << "(ray, hit, surf), medium_interface,"
+               << " @lights(" << light_id_str << "));" << std::endl
                << std::endl;
     } else {
-        stream << "  let " << output_var << " : Shader = @|ray, hit, surf| make_material(" << mat_id << ", bsdf_" << LoaderUtils::escapeIdentifier(material.BSDF) << "(ray, hit, surf), medium_interface);" << std::endl
+        stream << "  let " << output_var << " : Shader = @|ray, hit, surf| make_material(" << mat_id_str << ", bsdf_" << LoaderUtils::escapeIdentifier(material.BSDF) << "(ray, hit, surf), medium_interface);" << std::endl
                << std::endl;
     }
 
@@ -102,7 +142,7 @@ std::string ShaderUtils::inlineSPI(const LoaderContext& ctx)
     if (ctx.SamplesPerIteration == 1) // Hardcode this case as some optimizations might apply
         stream << ctx.SamplesPerIteration << " : i32";
     else // Fallback to dynamic spi
-        stream << "registry::get_parameter_i32(\"__spi\", 1)";
+        stream << "registry::get_parameter_i32_by_slot(" << ctx.Parameters->resolveInt("__spi", 1) << ")";
 
     // We do not hardcode the spi as default to prevent recompilations if spi != 1
     return stream.str();
@@ -9,6 +9,10 @@ public:
     static std::string constructDevice(Target target);
     static std::string generateDatabase();
     static std::string generateMaterialShader(ShadingTree& tree, size_t mat_id, bool requireLights, const std::string_view& output_var);
+    /// Will generate a single material shader shared by all the given materials.
+    /// The materials are expected to only differ in their id and associated area light, see HitShader::groupMaterials.
+    /// The actual material id has to be available at runtime with the name given by mat_id_var
+    static std::string generateMaterialShader(ShadingTree& tree, const std::vector<size_t>& mat_ids, bool requireLights, const std::string_view& output_var, const std::string_view& mat_id_var);
 
     /// Will generate technique predefinition, function specification and device
     static std::string beginCallback(const LoaderContext& ctx);
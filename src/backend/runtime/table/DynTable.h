@@ -13,10 +13,11 @@ class DynTable {
 public:
     DynTable() = default;
 
-    inline size_t entryCount() const { return mLookups.size(); }
+    inline size_t entryCount() const { return isExternal() ? mExternalLookupCount : mLookups.size(); }
     inline void reserve(size_t size) { mData.reserve(size); }
     inline std::vector<uint8>& addLookup(uint32 typeID, uint32 flags, size_t alignment)
     {
+        IG_ASSERT(!isExternal(), "Trying to modify a table with external storage");
         if (alignment != 0 && !mData.empty()) {
             size_t defect = alignment - mData.size() % alignment;
             mData.resize(mData.size() + defect);
@@ -26,11 +27,79 @@ public:
         return mData;
     }
 
-    inline const std::vector<LookupEntry>& lookups() const { return mLookups; }
-    inline const std::vector<uint8>& data() const { return mData; }
+    /// Add an entry for each given data size and allocate the whole data at once. The layout is the same as with consecutive calls to addLookup.
+    /// Returns the id of the first new entry. The data of the entries can be filled independently afterwards, e.g., in parallel
+    inline size_t addLookups(uint32 typeID, uint32 flags, size_t alignment, const std::vector<size_t>& sizes)
+    {
+        IG_ASSERT(!isExternal(), "Trying to modify a table with external storage");
+        const size_t first = mLookups.size();
+        mLookups.reserve(first + sizes.size());
+
+        size_t end = mData.size();
+        for (size_t size : sizes) {
+            if (alignment != 0 && end != 0)
+                end += alignment - end % alignment;
+
+            mLookups.push_back(LookupEntry{ typeID, flags, (uint64)end });
+            end += size;
+        }
+
+        mData.resize(end);
+        return first;
+    }
+
+    /// Use the given memory (e.g., a mapped file) instead of own storage. The owner keeps the memory alive as long as the table exists.
+    /// A table with external storage is read-only
+    inline void assignExternal(const std::shared_ptr<const void>& owner, const LookupEntry* lookups, size_t lookupCount, const uint8* data, size_t dataSize)
+    {
+        mLookups.clear();
+        mData.clear();
+
+        mExternalOwner       = owner;
+        mExternalLookups     = lookups;
+        mExternalLookupCount = lookupCount;
+        mExternalData        = data;
+        mExternalDataSize    = dataSize;
+    }
+
+    inline bool isExternal() const { return mExternalOwner != nullptr; }
+
+    // Access valid for both own and external storage
+    inline const LookupEntry* lookupPtr() const { return isExternal() ? mExternalLookups : mLookups.data(); }
+    inline const LookupEntry& lookup(size_t id) const { return lookupPtr()[id]; }
+    inline const uint8* dataPtr() const { return isExternal() ? mExternalData : mData.data(); }
+    inline size_t dataSize() const { return isExternal() ? mExternalDataSize : mData.size(); }
+
+    // Access only valid for own storage
+    inline const std::vector<LookupEntry>& lookups() const
+    {
+        IG_ASSERT(!isExternal(), "Trying to access storage of a table with external storage");
+        return mLookups;
+    }
+    inline const std::vector<uint8>& data() const
+    {
+        IG_ASSERT(!isExternal(), "Trying to access storage of a table with external storage");
+        return mData;
+    }
+    inline std::vector<uint8>& data()
+    {
+        IG_ASSERT(!isExternal(), "Trying to modify a table with external storage");
+        return mData;
+    }
+    inline uint8* entryData(size_t id)
+    {
+        IG_ASSERT(!isExternal(), "Trying to modify a table with external storage");
+        return mData.data() + mLookups[id].Offset;
+    }
 
 private:
     std::vector<LookupEntry> mLookups;
     std::vector<uint8> mData;
+
+    std::shared_ptr<const void> mExternalOwner;
+    const LookupEntry* mExternalLookups = nullptr;
+    size_t mExternalLookupCount         = 0;
+    const uint8* mExternalData          = nullptr;
+    size_t mExternalDataSize            = 0;
 };
-} // namespace IG
\ No newline at end of file
+} // namespace IG
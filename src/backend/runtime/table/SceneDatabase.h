@@ -4,6 +4,9 @@
 #include "math/BoundingBox.h"
 
 namespace IG {
+/// Name of the custom table containing material parameters
+constexpr const char* MaterialParameterTableName = "MaterialParameters";
+
 struct SceneBVH {
     std::vector<uint8> Nodes;
     std::vector<uint8> Leaves;
@@ -19,6 +22,7 @@ struct SceneDatabase {
     float SceneRadius;
     BoundingBox SceneBBox;
     size_t MaterialCount;
-    std::vector<uint32> EntityToMaterial; // Map from Entity -> Material (It would be better to get rid of this, but sorting by entity is "better" than sorting for material)
+    std::vector<uint32> EntityToMaterial; // Map from Entity -> Material. Primary rays are sorted by entity, or by material if requested
+    std::unordered_map<std::string, size_t> MaterialParameters; // Map from '<bsdf>.<parameter>' -> Offset (in floats) inside the material parameter table. Only used if the table is enabled
 };
 } // namespace IG
\ No newline at end of file
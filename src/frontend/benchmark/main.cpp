@@ -0,0 +1,301 @@
+#include "Logger.h"
+#include "Runtime.h"
+#include "Timer.h"
+#include "config/Build.h"
+
+#include <CLI/CLI.hpp>
+
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+using namespace IG;
+
+static const std::map<std::string, Target> TargetMap{ { "generic", Target::GENERIC }, { "single", Target::SINGLE }, { "asimd", Target::ASIMD }, { "sse42", Target::SSE42 }, { "avx", Target::AVX }, { "avx2", Target::AVX2 }, { "avx512", Target::AVX512 }, { "amdgpu", Target::AMDGPU }, { "nvvm", Target::NVVM } };
+
+struct BenchmarkOptions {
+    std::vector<std::filesystem::path> Scenes = { IG_BENCHMARK_SCENE_DIR "/diamond_scene.json", IG_BENCHMARK_SCENE_DIR "/many_point_lights_scene.json", IG_BENCHMARK_SCENE_DIR "/room_tensortree.json" };
+    std::vector<std::string> Techniques;
+    std::string Target;
+    uint32 Device     = 0;
+    uint32 SPI        = 0; // Detect automatically
+    size_t Runs       = 3;
+    size_t Warmup     = 2;
+    size_t Iterations = 10;
+
+    std::pair<uint32, uint32> FilmSize = { 0, 0 }; // Use film size of the scene
+    std::filesystem::path Output;
+    std::filesystem::path Baseline;
+    float Threshold = 0.05f;
+};
+
+struct Summary {
+    double Min    = 0;
+    double Median = 0;
+    double Max    = 0;
+    double Mean   = 0;
+    double StdDev = 0;
+};
+
+static Summary summarize(std::vector<double> values)
+{
+    Summary summary;
+    if (values.empty())
+        return summary;
+
+    std::sort(values.begin(), values.end());
+    summary.Min    = values.front();
+    summary.Median = values[values.size() / 2];
+    summary.Max    = values.back();
+    summary.Mean   = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+
+    double variance = 0;
+    for (double v : values)
+        variance += (v - summary.Mean) * (v - summary.Mean);
+    summary.StdDev = std::sqrt(variance / values.size());
+    return summary;
+}
+
+struct BenchmarkResult {
+    std::string Scene;
+    std::string Technique;
+    std::string Target;
+    Summary SamplesPerSecond; // In Msamples/s, one entry per measured iteration
+    Summary RaysPerSecond;    // In Mrays/s, one entry per run
+    Summary LoadMS;           // Including shader compilation
+    Summary CompileMS;
+
+    inline std::string key() const { return Scene + ";" + Technique + ";" + Target; }
+};
+
+static std::optional<BenchmarkResult> run_benchmark(const std::filesystem::path& scene, const std::string& technique, Target target, const BenchmarkOptions& bopts)
+{
+    RuntimeOptions opts;
+    opts.DesiredTarget     = target;
+    opts.Device            = bopts.Device;
+    opts.SPI               = bopts.SPI;
+    opts.AcquireStats      = true; // Required for the number of rays
+    opts.OverrideTechnique = technique;
+    opts.OverrideFilmSize  = bopts.FilmSize;
+
+    std::vector<double> samples_sec;
+    std::vector<double> rays_sec;
+    std::vector<double> load_ms;
+    std::vector<double> compile_ms;
+
+    BenchmarkResult result;
+    result.Scene = scene.filename().generic_u8string();
+
+    // Every run loads the scene again, which gives a variance for the load and compile times as well
+    for (size_t run = 0; run < bopts.Runs; ++run) {
+        Timer timer_load;
+        timer_load.start();
+
+        std::unique_ptr<Runtime> runtime;
+        try {
+            runtime = std::make_unique<Runtime>(opts);
+        } catch (const std::exception& e) {
+            IG_LOG(L_ERROR) << e.what() << std::endl;
+            return std::nullopt;
+        }
+
+        if (!runtime->loadFromFile(scene)) {
+            IG_LOG(L_ERROR) << "Could not load " << scene << std::endl;
+            return std::nullopt;
+        }
+
+        load_ms.push_back((double)timer_load.stopMS());
+        compile_ms.push_back((double)runtime->loadingTimings().CompileMS);
+
+        result.Technique = runtime->technique();
+        result.Target    = targetToString(runtime->target());
+
+        const auto def = runtime->initialCameraOrientation();
+        runtime->setParameter("__camera_eye", def.Eye);
+        runtime->setParameter("__camera_dir", def.Dir);
+        runtime->setParameter("__camera_up", def.Up);
+
+        for (size_t i = 0; i < bopts.Warmup; ++i)
+            runtime->step();
+
+        const auto countRays = [&]() {
+            const Statistics* stats = runtime->getStatistics();
+            return stats->quantity(Quantity::CameraRayCount) + stats->quantity(Quantity::BounceRayCount) + stats->quantity(Quantity::ShadowRayCount);
+        };
+
+        const uint64 rays_before  = countRays();
+        const double samples_iter = double(runtime->samplesPerIteration() * runtime->framebufferWidth() * runtime->framebufferHeight());
+        double render_sec         = 0;
+        for (size_t i = 0; i < bopts.Iterations; ++i) {
+            const auto ticks = std::chrono::high_resolution_clock::now();
+            runtime->step();
+            const double elapsed_sec = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - ticks).count();
+
+            render_sec += elapsed_sec;
+            samples_sec.push_back(samples_iter / elapsed_sec * 1e-6);
+        }
+        rays_sec.push_back(double(countRays() - rays_before) / render_sec * 1e-6);
+    }
+
+    result.SamplesPerSecond = summarize(samples_sec);
+    result.RaysPerSecond    = summarize(rays_sec);
+    result.LoadMS           = summarize(load_ms);
+    result.CompileMS        = summarize(compile_ms);
+    return result;
+}
+
+static void print_result(const BenchmarkResult& result)
+{
+    std::stringstream stream;
+    stream << std::fixed << std::setprecision(3)
+           << "# " << result.Scene << " [" << result.Technique << ", " << result.Target << "]" << std::endl
+           << "  Samples> " << result.SamplesPerSecond.Min << "/" << result.SamplesPerSecond.Median << "/" << result.SamplesPerSecond.Max << " (min/med/max Msamples/s) +- " << result.SamplesPerSecond.StdDev << std::endl
+           << "  Rays>    " << result.RaysPerSecond.Min << "/" << result.RaysPerSecond.Median << "/" << result.RaysPerSecond.Max << " (min/med/max Mrays/s) +- " << result.RaysPerSecond.StdDev << std::endl
+           << "  Loading> " << result.LoadMS.Mean << "ms +- " << result.LoadMS.StdDev << "ms" << std::endl
+           << "  JIT>     " << result.CompileMS.Mean << "ms +- " << result.CompileMS.StdDev << "ms" << std::endl;
+    std::cout << stream.str() << std::flush;
+}
+
+// Results are stored as plain CSV, such that they can be compared and processed by other tools easily
+static constexpr const char* CSVHeader = "scene;technique;target;samples_min;samples_median;samples_max;samples_stddev;rays_median;rays_stddev;load_ms;load_stddev;jit_ms;jit_stddev";
+
+static bool write_results(const std::filesystem::path& path, const std::vector<BenchmarkResult>& results)
+{
+    std::ofstream stream(path);
+    if (!stream)
+        return false;
+
+    stream << CSVHeader << std::endl;
+    for (const auto& result : results) {
+        stream << result.key() << ";"
+               << result.SamplesPerSecond.Min << ";" << result.SamplesPerSecond.Median << ";" << result.SamplesPerSecond.Max << ";" << result.SamplesPerSecond.StdDev << ";"
+               << result.RaysPerSecond.Median << ";" << result.RaysPerSecond.StdDev << ";"
+               << result.LoadMS.Mean << ";" << result.LoadMS.StdDev << ";"
+               << result.CompileMS.Mean << ";" << result.CompileMS.StdDev << std::endl;
+    }
+    return true;
+}
+
+/// Returns the median Msamples/s for each entry in the given file
+static std::optional<std::unordered_map<std::string, double>> read_baseline(const std::filesystem::path& path)
+{
+    std::ifstream stream(path);
+    if (!stream)
+        return std::nullopt;
+
+    std::unordered_map<std::string, double> baseline;
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (line.empty() || line == CSVHeader)
+            continue;
+
+        std::vector<std::string> cols;
+        std::stringstream line_stream(line);
+        std::string col;
+        while (std::getline(line_stream, col, ';'))
+            cols.push_back(col);
+
+        if (cols.size() < 5) {
+            IG_LOG(L_WARNING) << "Ignoring invalid baseline entry '" << line << "'" << std::endl;
+            continue;
+        }
+
+        try {
+            baseline[cols[0] + ";" + cols[1] + ";" + cols[2]] = std::stod(cols[4]);
+        } catch (const std::exception&) {
+            IG_LOG(L_WARNING) << "Ignoring baseline entry '" << line << "' with invalid throughput '" << cols[4] << "'" << std::endl;
+        }
+    }
+    return baseline;
+}
+
+// This application renders a list of scenes for a fixed number of iterations and reports the throughput.
+// If a baseline is given, the application fails if the median throughput of any entry regressed beyond the threshold
+int main(int argc, char** argv)
+{
+    BenchmarkOptions bopts;
+
+    CLI::App app{ "Ignis Benchmark Suite", argc >= 1 ? argv[0] : "unknown" };
+
+    app.set_version_flag("--version", Build::getBuildString());
+    app.set_help_flag("-h,--help", "Shows help message and exit");
+
+    app.add_option("scenes", bopts.Scenes, "Scene files to benchmark. Defaults to a set of bundled scenes")->check(CLI::ExistingFile);
+    app.add_option("--technique", bopts.Techniques, "Techniques to benchmark for each scene. Defaults to the technique given by the scene");
+    app.add_option("--target", bopts.Target, "Sets the target platform (default: autodetect GPU)")->check(CLI::IsMember(TargetMap, CLI::ignore_case));
+    app.add_option("--device", bopts.Device, "Sets the device to use on the selected platform");
+    app.add_option("--spi", bopts.SPI, "Number of samples per iteration. This is only considered a hint for the underlying technique");
+    app.add_option("--width", bopts.FilmSize.first, "Override the viewport horizontal dimension (in pixels)");
+    app.add_option("--height", bopts.FilmSize.second, "Override the viewport vertical dimension (in pixels)");
+    app.add_option("-r,--runs", bopts.Runs, "Number of times each scene is loaded and rendered")->check(CLI::PositiveNumber);
+    app.add_option("-w,--warmup", bopts.Warmup, "Number of iterations rendered before measuring");
+    app.add_option("-n,--iterations", bopts.Iterations, "Number of measured iterations per run")->check(CLI::PositiveNumber);
+    app.add_option("-o,--output", bopts.Output, "Write the results as CSV to the given file, which can be used as a baseline later");
+    app.add_option("--baseline", bopts.Baseline, "Compare the median throughput against the given CSV file of a previous run")->check(CLI::ExistingFile);
+    app.add_option("--threshold", bopts.Threshold, "Relative throughput regression to the baseline which is considered a failure");
+
+    try {
+        app.parse(argc, argv);
+    } catch (const CLI::ParseError& e) {
+        return app.exit(e);
+    }
+
+    std::cout << Build::getCopyrightString() << std::endl;
+
+    Target target = Target::INVALID;
+    for (const auto& pair : TargetMap) {
+        if (CLI::detail::to_lower(bopts.Target) == pair.first)
+            target = pair.second;
+    }
+
+    if (bopts.Techniques.empty())
+        bopts.Techniques.push_back({}); // Use technique of the scene
+
+    std::vector<BenchmarkResult> results;
+    for (const auto& scene : bopts.Scenes) {
+        for (const auto& technique : bopts.Techniques) {
+            auto result = run_benchmark(scene, technique, target, bopts);
+            if (!result.has_value())
+                return EXIT_FAILURE;
+
+            print_result(result.value());
+            results.push_back(result.value());
+        }
+    }
+
+    if (!bopts.Output.empty()) {
+        if (!write_results(bopts.Output, results))
+            IG_LOG(L_ERROR) << "Failed to save results to " << bopts.Output << std::endl;
+        else
+            IG_LOG(L_INFO) << "Results saved to " << bopts.Output << std::endl;
+    }
+
+    if (bopts.Baseline.empty())
+        return EXIT_SUCCESS;
+
+    const auto baseline = read_baseline(bopts.Baseline);
+    if (!baseline.has_value()) {
+        IG_LOG(L_ERROR) << "Could not read baseline " << bopts.Baseline << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    bool regressed = false;
+    for (const auto& result : results) {
+        const auto it = baseline->find(result.key());
+        if (it == baseline->end()) {
+            IG_LOG(L_WARNING) << "No baseline available for " << result.key() << std::endl;
+            continue;
+        }
+
+        const double ratio = result.SamplesPerSecond.Median / it->second;
+        if (ratio < 1 - bopts.Threshold) {
+            IG_LOG(L_ERROR) << "Throughput of " << result.key() << " regressed to " << ratio * 100 << "% of the baseline" << std::endl;
+            regressed = true;
+        } else {
+            IG_LOG(L_INFO) << "Throughput of " << result.key() << " is at " << ratio * 100 << "% of the baseline" << std::endl;
+        }
+    }
+
+    return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "IO.h"
+#include "Logger.h"
+#include "Runtime.h"
+
+#include <chrono>
+#include <future>
+
+namespace IG {
+/// Periodically writes the framebuffer and all AOVs to the output file while rendering.
+/// Only the copy of the framebuffer happens on the calling thread, the image is encoded and written on a separate thread while the next iterations render.
+/// The image is written to a temporary file first and renamed afterwards, such that the output is always a complete image
+class CheckpointWriter {
+public:
+    CheckpointWriter(const std::filesystem::path& path, float intervalSeconds)
+        : mPath(path)
+        , mTemporaryPath(path)
+        , mInterval(std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(std::chrono::duration<float>(intervalSeconds)))
+        , mLastCheckpoint(std::chrono::high_resolution_clock::now())
+    {
+        // Keep the extension, as it selects the image format
+        mTemporaryPath.replace_extension(".checkpoint" + path.extension().generic_u8string());
+    }
+
+    inline ~CheckpointWriter()
+    {
+        wait();
+    }
+
+    inline bool isEnabled() const { return mInterval.count() > 0; }
+
+    /// Start a new checkpoint if the interval passed since the last one. If the previous checkpoint is still being written, the new one is postponed
+    inline void update(const Runtime& runtime)
+    {
+        if (!isEnabled())
+            return;
+
+        const auto now = std::chrono::high_resolution_clock::now();
+        if (now - mLastCheckpoint < mInterval)
+            return;
+
+        if (mPending.valid() && mPending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return;
+
+        wait();
+
+        // The last checkpoint finished, therefore its buffer can be reused
+        captureImageOutput(mOutput, runtime, nullptr);
+        mPending = std::async(std::launch::async, [this]() {
+            if (!saveImageOutput(mTemporaryPath, mOutput))
+                return false;
+
+            std::error_code error;
+            std::filesystem::rename(mTemporaryPath, mPath, error);
+            return !error;
+        });
+
+        IG_LOG(L_DEBUG) << "Writing checkpoint with " << runtime.currentSampleCount() << " spp to " << mPath << std::endl;
+        mLastCheckpoint = now;
+    }
+
+    /// Wait for the current checkpoint to be written
+    inline void wait()
+    {
+        if (mPending.valid() && !mPending.get())
+            IG_LOG(L_ERROR) << "Failed to save checkpoint " << mPath << std::endl;
+    }
+
+private:
+    const std::filesystem::path mPath;
+    std::filesystem::path mTemporaryPath;
+    const std::chrono::high_resolution_clock::duration mInterval;
+    std::chrono::high_resolution_clock::time_point mLastCheckpoint;
+
+    ImageOutput mOutput;
+    std::future<bool> mPending;
+};
+} // namespace IG
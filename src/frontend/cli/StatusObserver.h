@@ -57,6 +57,9 @@ public:
         std::cout << "Done" << std::setw(120) << " " << std::endl;
     }
 
+    /// Change the number of samples the progress is based on, e.g., if it is only estimated
+    inline void setTargetSamples(uint64 targetSamples) { mTargetSamples = targetSamples; }
+
     inline void update(uint64 currentSamples)
     {
         constexpr int PERC_OUTPUT_FIELD_SIZE = 6; // Percentage
@@ -127,7 +130,7 @@ private:
 
     const bool mBeautify;
     const uint64 mUpdateCycleSeconds;
-    const uint64 mTargetSamples;
+    uint64 mTargetSamples;
     std::chrono::high_resolution_clock::time_point mStart;
     std::chrono::high_resolution_clock::time_point mLastUpdate;
     bool mFirstTime;
@@ -1,7 +1,10 @@
 #include "Camera.h"
+#include "CheckpointWriter.h"
+#include "ErrorEstimator.h"
 #include "IO.h"
 #include "Logger.h"
 #include "ProgramOptions.h"
+#include "RenderBudget.h"
 #include "Runtime.h"
 #include "StatusObserver.h"
 #include "Timer.h"
@@ -65,8 +68,8 @@ int main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
-    if (cmd.SPP.value_or(0) <= 0) {
-        IG_LOG(L_ERROR) << "No valid spp count given" << std::endl;
+    if (cmd.SPP.value_or(0) <= 0 && cmd.TimeBudget.value_or(0) <= 0 && cmd.TargetError.value_or(0) <= 0) {
+        IG_LOG(L_ERROR) << "No valid spp count, time budget or target error given" << std::endl;
         return EXIT_FAILURE;
     }
 
@@ -101,11 +104,18 @@ int main(int argc, char** argv)
     runtime->setParameter("__camera_up", cmd.UpVector().value_or(def.Up));
 
     const size_t SPI          = runtime->samplesPerIteration();
-    const size_t desired_iter = static_cast<size_t>(std::ceil(cmd.SPP.value_or(0) / (float)SPI));
+    const size_t desired_iter = static_cast<size_t>(std::ceil(std::max(0, cmd.SPP.value_or(0)) / (float)SPI)); // Zero if not limited
 
     if (cmd.SPP.has_value() && (cmd.SPP.value() % SPI) != 0)
         IG_LOG(L_WARNING) << "Given spp " << cmd.SPP.value() << " is not a multiple of the spi " << SPI << ". Using spp " << desired_iter * SPI << " instead" << std::endl;
 
+    RenderBudget budget(desired_iter, 1000 * std::max(0.0f, cmd.TimeBudget.value_or(0)), std::max(0.0f, cmd.TargetError.value_or(0)));
+    ErrorEstimator error_estimator;
+    CheckpointWriter checkpoint_writer(cmd.Output, std::max(0.0f, cmd.CheckpointInterval));
+
+    if (budget.hasTargetError() && !budget.isBounded())
+        IG_LOG(L_WARNING) << "Only a target error is given. Rendering will not stop if the estimated error never drops below it, e.g., for techniques using multiple passes. Consider adding --spp or --time-budget" << std::endl;
+
     StatusObserver observer(!cmd.NoColor, 2, desired_iter * SPI /* Approx */);
     observer.begin();
 
@@ -118,6 +128,9 @@ int main(int argc, char** argv)
         if (!cmd.NoProgress)
             observer.update(runtime->currentSampleCount());
 
+        // Converged pixels are skipped by the adaptive sampler and do not count as samples
+        const size_t active_pixels = runtime->isAdaptiveSampling() ? runtime->activePixelCount() : runtime->framebufferWidth() * runtime->framebufferHeight();
+
         auto ticks = std::chrono::high_resolution_clock::now();
 
         timer_render.start();
@@ -126,14 +139,37 @@ int main(int argc, char** argv)
 
         auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - ticks).count();
 
-        samples_sec.emplace_back(1000.0 * double(SPI * runtime->framebufferWidth() * runtime->framebufferHeight()) / double(elapsed_ms));
-        if (samples_sec.size() == desired_iter)
+        samples_sec.emplace_back(1000.0 * double(SPI * active_pixels) / double(elapsed_ms));
+
+        if (budget.hasTargetError())
+            budget.setError(error_estimator.update(runtime->getFramebuffer(0), runtime->framebufferWidth() * runtime->framebufferHeight(), runtime->currentIterationCount()));
+        checkpoint_writer.update(*runtime);
+
+        // The time spent on the error estimate and checkpoints counts towards the budget as well
+        budget.addIteration(std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - ticks).count());
+        if (budget.isExhausted())
+            break;
+
+        // Further iterations would not change the image anymore
+        if (runtime->isAdaptiveSampling() && runtime->activePixelCount() == 0) {
+            IG_LOG(L_INFO) << "All pixels converged after " << runtime->currentIterationCount() << " iterations" << std::endl;
             break;
+        }
+
+        const size_t remaining_iter = budget.estimateRemainingIterations();
+        if (remaining_iter > 0)
+            observer.setTargetSamples((runtime->currentIterationCount() + remaining_iter) * SPI);
     }
 
     if (!cmd.NoProgress)
         observer.end();
 
+    if (budget.hasTargetError())
+        IG_LOG(L_INFO) << "Estimated relative error after " << runtime->currentIterationCount() << " iterations is " << budget.error() << std::endl;
+
+    // The last checkpoint writes to the same file as the final output
+    checkpoint_writer.wait();
+
     SectionTimer timer_saving;
     timer_saving.start();
     if (!saveImageOutput(cmd.Output, *runtime, nullptr))
@@ -157,6 +193,19 @@ int main(int argc, char** argv)
             << "    Saving>  " << beautiful_time(timer_saving.duration_ms) << std::endl;
     }
 
+    if (!cmd.StatsFile.empty()) {
+        if (!saveStatisticsOutput(cmd.StatsFile, *runtime, timer_render.duration_ms))
+            IG_LOG(L_ERROR) << "Failed to save statistics to " << cmd.StatsFile << std::endl;
+        else
+            IG_LOG(L_INFO) << "Statistics saved to " << cmd.StatsFile << std::endl;
+    }
+
+    auto timeline = runtime->getTimeline();
+    if (timeline) {
+        if (timeline->writeChromeTrace(cmd.TimelineFile))
+            IG_LOG(L_INFO) << "Timeline saved to " << cmd.TimelineFile << std::endl;
+    }
+
     runtime.reset();
 
     IG_LOG(L_INFO) << "Rendering took " << beautiful_time(timer_all.duration_ms) << std::endl;
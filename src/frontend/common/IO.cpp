@@ -3,6 +3,8 @@
 #include "ImageIO.h"
 #include "Runtime.h"
 
+#include <fstream>
+
 IG_BEGIN_IGNORE_WARNINGS
 #include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
@@ -64,7 +66,7 @@ bool saveImageRGBA(const std::filesystem::path& path, const float* rgb, size_t w
     return img.save(path);
 }
 
-bool saveImageOutput(const std::filesystem::path& path, const Runtime& runtime, const CameraOrientation* currentOrientation)
+void captureImageOutput(ImageOutput& output, const Runtime& runtime, const CameraOrientation* currentOrientation)
 {
     const size_t width  = runtime.framebufferWidth();
     const size_t height = runtime.framebufferHeight();
@@ -74,14 +76,17 @@ bool saveImageOutput(const std::filesystem::path& path, const Runtime& runtime,
 
     size_t aov_count = runtime.aovs().size() + 1;
 
-    std::vector<float> images(width * height * 3 * aov_count);
+    output.Width  = width;
+    output.Height = height;
+    output.Images.resize(width * height * 3 * aov_count);
+    output.Names.resize(3 * aov_count);
 
     // Copy data
     for (size_t aov = 0; aov < aov_count; ++aov) {
         const float* src = runtime.getFramebuffer((int)aov);
-        float* dst_r     = &images[width * height * (3 * aov + 0)];
-        float* dst_g     = &images[width * height * (3 * aov + 1)];
-        float* dst_b     = &images[width * height * (3 * aov + 2)];
+        float* dst_r     = &output.Images[width * height * (3 * aov + 0)];
+        float* dst_g     = &output.Images[width * height * (3 * aov + 1)];
+        float* dst_b     = &output.Images[width * height * (3 * aov + 2)];
 
         const auto pixelF = [&](size_t ind) {
             float r = src[ind * 3 + 0];
@@ -100,46 +105,74 @@ bool saveImageOutput(const std::filesystem::path& path, const Runtime& runtime,
                           });
     }
 
-    std::vector<const float*> image_ptrs(3 * aov_count);
-    std::vector<std::string> image_names(3 * aov_count);
     for (size_t aov = 0; aov < aov_count; ++aov) {
-        // Swizzle RGB to BGR as some viewers expect it per default
-        image_ptrs[3 * aov + 2] = &images[width * height * (3 * aov + 0)];
-        image_ptrs[3 * aov + 1] = &images[width * height * (3 * aov + 1)];
-        image_ptrs[3 * aov + 0] = &images[width * height * (3 * aov + 2)];
-
         // Framebuffer
         if (aov == 0) {
             if (aov_count == 1) {
                 // If we have no aovs, stick to the standard naming
-                image_names[3 * aov + 0] = "B";
-                image_names[3 * aov + 1] = "G";
-                image_names[3 * aov + 2] = "R";
+                output.Names[3 * aov + 0] = "B";
+                output.Names[3 * aov + 1] = "G";
+                output.Names[3 * aov + 2] = "R";
             } else {
-                image_names[3 * aov + 0] = "Default.B";
-                image_names[3 * aov + 1] = "Default.G";
-                image_names[3 * aov + 2] = "Default.R";
+                output.Names[3 * aov + 0] = "Default.B";
+                output.Names[3 * aov + 1] = "Default.G";
+                output.Names[3 * aov + 2] = "Default.R";
             }
         } else {
-            std::string name         = runtime.aovs()[aov - 1];
-            image_names[3 * aov + 0] = name + ".B";
-            image_names[3 * aov + 1] = name + ".G";
-            image_names[3 * aov + 2] = name + ".R";
+            std::string name          = runtime.aovs()[aov - 1];
+            output.Names[3 * aov + 0] = name + ".B";
+            output.Names[3 * aov + 1] = name + ".G";
+            output.Names[3 * aov + 2] = name + ".R";
         }
     }
 
     // Populate meta data information
-    ImageMetaData metaData;
-    metaData.CameraType     = runtime.camera();
-    metaData.TechniqueType  = runtime.technique();
-    metaData.SamplePerPixel = runtime.currentSampleCount();
+    output.MetaData                = ImageMetaData();
+    output.MetaData.CameraType     = runtime.camera();
+    output.MetaData.TechniqueType  = runtime.technique();
+    output.MetaData.SamplePerPixel = runtime.currentSampleCount();
 
     const CameraOrientation orientation = currentOrientation ? *currentOrientation : runtime.initialCameraOrientation();
 
-    metaData.CameraEye = orientation.Eye;
-    metaData.CameraUp  = orientation.Up;
-    metaData.CameraDir = orientation.Dir;
+    output.MetaData.CameraEye = orientation.Eye;
+    output.MetaData.CameraUp  = orientation.Up;
+    output.MetaData.CameraDir = orientation.Dir;
+}
+
+bool saveImageOutput(const std::filesystem::path& path, const ImageOutput& output)
+{
+    const size_t plane_size = output.Width * output.Height;
+    const size_t aov_count  = output.Names.size() / 3;
+
+    std::vector<const float*> image_ptrs(3 * aov_count);
+    for (size_t aov = 0; aov < aov_count; ++aov) {
+        // Swizzle RGB to BGR as some viewers expect it per default
+        image_ptrs[3 * aov + 2] = &output.Images[plane_size * (3 * aov + 0)];
+        image_ptrs[3 * aov + 1] = &output.Images[plane_size * (3 * aov + 1)];
+        image_ptrs[3 * aov + 0] = &output.Images[plane_size * (3 * aov + 2)];
+    }
+
+    return ImageIO::save(path, output.Width, output.Height, image_ptrs, output.Names, output.MetaData);
+}
+
+bool saveImageOutput(const std::filesystem::path& path, const Runtime& runtime, const CameraOrientation* currentOrientation)
+{
+    ImageOutput output;
+    captureImageOutput(output, runtime, currentOrientation);
+    return saveImageOutput(path, output);
+}
+
+bool saveStatisticsOutput(const std::filesystem::path& path, const Runtime& runtime, size_t totalMS)
+{
+    const std::string json = runtime.getStatisticsAsJSON(totalMS);
+    if (json.empty())
+        return false;
+
+    std::ofstream stream(path);
+    if (!stream)
+        return false;
 
-    return ImageIO::save(path, width, height, image_ptrs, image_names, metaData);
+    stream << json << std::endl;
+    return true;
 }
 } // namespace IG
\ No newline at end of file
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "IG_Config.h"
+#include "ImageIO.h"
 
 namespace IG {
 bool saveImageRGB(const std::filesystem::path& path, const float* rgb, size_t width, size_t height, float scale);
@@ -8,5 +8,19 @@ bool saveImageRGBA(const std::filesystem::path& path, const float* rgba, size_t
 
 struct CameraOrientation;
 class Runtime;
+
+/// Copy of the framebuffer and all AOVs, normalized by the number of iterations. Can be saved independently of the runtime
+struct ImageOutput {
+    size_t Width  = 0;
+    size_t Height = 0;
+    std::vector<float> Images; // Each channel is stored as a separate plane
+    std::vector<std::string> Names;
+    ImageMetaData MetaData;
+};
+
+void captureImageOutput(ImageOutput& output, const Runtime& runtime, const CameraOrientation* currentOrientation);
+bool saveImageOutput(const std::filesystem::path& path, const ImageOutput& output);
 bool saveImageOutput(const std::filesystem::path& path, const Runtime& runtime, const CameraOrientation* currentOrientation);
+/// Write the statistics of the runtime as a JSON file. The total time of the session is given in milliseconds
+bool saveStatisticsOutput(const std::filesystem::path& path, const Runtime& runtime, size_t totalMS);
 } // namespace IG
\ No newline at end of file
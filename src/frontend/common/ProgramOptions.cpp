@@ -1,5 +1,6 @@
 #include "ProgramOptions.h"
 #include "Runtime.h"
+#include "bvh/BvhBuildOptions.h"
 #include "config/Build.h"
 
 #include <CLI/CLI.hpp>
@@ -125,20 +126,46 @@ ProgramOptions::ProgramOptions(int argc, char** argv, ApplicationType type, cons
     app.add_option("--spi", SPI, "Number of samples per iteration. This is only considered a hint for the underlying technique");
     if (type == ApplicationType::View)
         app.add_option("--spp-mode", SPPMode, "Sets the current spp mode")->transform(MyTransformer(SPPModeMap, CLI::ignore_case))->default_str("fixed");
+    if (type == ApplicationType::CLI) {
+        app.add_option("--time-budget", TimeBudget, "Render until the given time in seconds is spent, excluding loading and saving. The number of iterations is estimated from the time of the previous ones");
+        app.add_option("--target-error", TargetError, "Render until the estimated relative root mean squared error of the image drops below the given value, e.g., 0.01");
+        app.add_option("--checkpoint", CheckpointInterval, "Write the current image to the output file every given number of seconds while rendering. Zero disables checkpoints")->default_val(0);
+    }
 
     app.add_flag("--stats", AcquireStats, "Acquire useful stats alongside rendering. Will be dumped at the end of the rendering session");
     app.add_flag("--stats-full", AcquireFullStats, "Acquire all stats alongside rendering. Will be dumped at the end of the rendering session");
+    if (type != ApplicationType::Trace)
+        app.add_option("--stats-json", StatsFile, "Acquire all stats alongside rendering and write them as JSON to the given file at the end of the rendering session");
+    if (type == ApplicationType::CLI)
+        app.add_option("--trace-timeline", TimelineFile, "Record begin and end of tiles, shader launches and sections for each thread and write them in the Chrome trace event format to the given file");
 
     app.add_flag("--dump-shader", DumpShader, "Dump produced shaders to files in the current working directory");
     app.add_flag("--dump-shader-full", DumpFullShader, "Dump produced shaders with standard library to files in the current working directory");
 
     app.add_option("--script-dir", ScriptDir, "Override internal script standard library by '.art' files from the given directory");
+    app.add_option("--shader-cache", ShaderCacheDir, "Cache compiled shaders in the given directory and reuse them in later runs");
+    app.add_option("--scene-cache", SceneCacheDir, "Cache loaded shapes and built BVHs in the given directory and reuse them in later runs if shapes, referenced files and BVH options are unchanged");
+    app.add_option("--shader-threads", ShaderCompileThreads, "Maximum number of threads used to compile shaders. Zero picks the number automatically. Unless built with IG_WITH_PARALLEL_JIT, the AnyDSL jit itself still compiles one shader at a time")->default_val(0);
+
+    app.add_option("--bvh", BVHPreset, "Preset used to build the BVHs, trading build time against traversal speed. Shapes may override it (default: quality)")->check(CLI::IsMember(BvhBuildOptions::getAvailablePresets(), CLI::ignore_case));
+
+    app.add_flag("--sort-out-of-place", SortPrimaryOutOfPlace, "Sort primary rays by scattering them into a second stream instead of swapping them in place. Faster for techniques with large payloads at the cost of memory. Only affects CPU targets");
+    app.add_flag("--sort-by-material", SortPrimaryByMaterial, "Sort primary rays by material instead of entity, such that each material is shaded in one large batch. Faster for scenes with many entities sharing few materials. Only affects CPU targets");
+
+    if (type != ApplicationType::Trace) {
+        app.add_option("--adaptive-threshold", AdaptiveThreshold, "Enable adaptive sampling and stop sampling pixels whose estimated relative error drops below the given threshold, e.g., 0.01. Only affects CPU targets and techniques with a single pass");
+        app.add_option("--adaptive-warmup", AdaptiveWarmup, "Number of iterations every pixel is sampled before adaptive sampling may consider it converged")->default_val(4);
+    }
 
     app.add_flag("--add-env-light", AddExtraEnvLight, "Add additional constant environment light. This is automatically done for glTF scenes without any lights");
+    app.add_flag("--material-table", UseMaterialParameterTable, "Store constant material parameters in a table instead of inlining them. Allows changing them without recompiling shaders at the cost of performance");
 
     if (type == ApplicationType::Trace) {
         app.add_option("-i,--input", InputRay, "Read list of rays from file instead of the standard input");
         app.add_option("-o,--output", Output, "Write radiance for each ray into file instead of standard output");
+        app.add_flag("--binary", BinaryRayIO, "Read rays and write radiance as raw float32 records instead of text. A ray is given by origin, direction, tmin and tmax, the radiance by rgb. Batches from the standard input are prefixed by the number of rays as uint64");
+        app.add_flag("--normalized", NormalizedRays, "Expect the given ray directions to be normalized already, which allows to skip the internal conversion");
+        app.add_option("--chunk-size", ChunkSize, "Trace the rays of a binary input file in chunks of the given number of rays, such that only a single chunk is uploaded at once. Zero traces all rays at once")->default_val(0);
     } else {
         app.add_option("-o,--output", Output, "Writes the output image to a file");
     }
@@ -160,23 +187,33 @@ void ProgramOptions::populate(RuntimeOptions& options) const
     options.IsTracer      = Type == ApplicationType::Trace;
     options.IsInteractive = Type == ApplicationType::View;
 
-    options.DesiredTarget  = Target;
-    options.RecommendCPU   = AutodetectCPU;
-    options.RecommendGPU   = AutodetectGPU;
-    options.Device         = Device;
-    options.AcquireStats   = AcquireStats || AcquireFullStats;
-    options.DumpShader     = DumpShader;
-    options.DumpShaderFull = DumpFullShader;
-    options.SPI            = SPI.value_or(0);
+    options.DesiredTarget   = Target;
+    options.RecommendCPU    = AutodetectCPU;
+    options.RecommendGPU    = AutodetectGPU;
+    options.Device          = Device;
+    options.AcquireStats    = AcquireStats || AcquireFullStats || !StatsFile.empty();
+    options.AcquireTimeline = !TimelineFile.empty();
+    options.DumpShader      = DumpShader;
+    options.DumpShaderFull  = DumpFullShader;
+    options.SPI             = SPI.value_or(0);
 
     options.OverrideTechnique = TechniqueType;
     options.OverrideCamera    = CameraType;
     if (Width.has_value() && Height.has_value())
         options.OverrideFilmSize = { Width.value(), Height.value() };
 
-    options.AddExtraEnvLight = AddExtraEnvLight;
-
-    options.ScriptDir = ScriptDir;
+    options.AddExtraEnvLight          = AddExtraEnvLight;
+    options.UseMaterialParameterTable = UseMaterialParameterTable;
+
+    options.ScriptDir             = ScriptDir;
+    options.ShaderCacheDir        = ShaderCacheDir;
+    options.SceneCacheDir         = SceneCacheDir;
+    options.ShaderCompileThreads  = ShaderCompileThreads;
+    options.BVHPreset             = BVHPreset;
+    options.SortPrimaryOutOfPlace = SortPrimaryOutOfPlace;
+    options.SortPrimaryByMaterial = SortPrimaryByMaterial;
+    options.AdaptiveThreshold     = AdaptiveThreshold;
+    options.AdaptiveWarmup        = AdaptiveWarmup;
 }
 
 } // namespace IG
\ No newline at end of file
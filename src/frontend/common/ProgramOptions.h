@@ -57,19 +57,37 @@ public:
     std::optional<int> SPI;
     IG::SPPMode SPPMode = SPPMode::Fixed;
 
+    std::optional<float> TimeBudget;  // In seconds
+    std::optional<float> TargetError; // Relative root mean squared error
+    float CheckpointInterval = 0;     // In seconds, disabled if zero
+
     bool AcquireStats     = false;
     bool AcquireFullStats = false;
+    std::filesystem::path StatsFile;
+    std::filesystem::path TimelineFile;
 
     bool DumpShader     = false;
     bool DumpFullShader = false;
 
-    bool AddExtraEnvLight = false;
+    bool AddExtraEnvLight          = false;
+    bool UseMaterialParameterTable = false;
 
     std::filesystem::path Output;
     std::filesystem::path InputScene;
     std::filesystem::path InputRay;
+    bool BinaryRayIO    = false;
+    bool NormalizedRays = false;
+    size_t ChunkSize    = 0;
 
     std::filesystem::path ScriptDir;
+    std::filesystem::path ShaderCacheDir;
+    std::filesystem::path SceneCacheDir;
+    std::string BVHPreset;
+    uint32 ShaderCompileThreads = 0;
+    bool SortPrimaryOutOfPlace  = false;
+    bool SortPrimaryByMaterial  = false;
+    float AdaptiveThreshold     = 0;
+    uint32 AdaptiveWarmup       = 4;
 
     void populate(RuntimeOptions& options) const;
 };
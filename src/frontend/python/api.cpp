@@ -82,8 +82,19 @@ PYBIND11_MODULE(pyignis, m)
         .def_readwrite("Device", &RuntimeOptions::Device)
         .def_readwrite("OverrideCamera", &RuntimeOptions::OverrideCamera)
         .def_readwrite("OverrideTechnique", &RuntimeOptions::OverrideTechnique)
+        .def_readwrite("ShaderCompileThreads", &RuntimeOptions::ShaderCompileThreads)
+        .def_readwrite("UseMaterialParameterTable", &RuntimeOptions::UseMaterialParameterTable)
+        .def_readwrite("BVHPreset", &RuntimeOptions::BVHPreset)
+        .def_readwrite("SortPrimaryOutOfPlace", &RuntimeOptions::SortPrimaryOutOfPlace)
+        .def_readwrite("SortPrimaryByMaterial", &RuntimeOptions::SortPrimaryByMaterial)
+        .def_readwrite("AdaptiveThreshold", &RuntimeOptions::AdaptiveThreshold)
+        .def_readwrite("AdaptiveWarmup", &RuntimeOptions::AdaptiveWarmup)
         .def_property(
-            "ModulePath", [](const RuntimeOptions& opts) { return opts.ModulePath.generic_u8string(); }, [](RuntimeOptions& opts, const std::string& val) { opts.ModulePath = val; });
+            "ModulePath", [](const RuntimeOptions& opts) { return opts.ModulePath.generic_u8string(); }, [](RuntimeOptions& opts, const std::string& val) { opts.ModulePath = val; })
+        .def_property(
+            "ShaderCacheDir", [](const RuntimeOptions& opts) { return opts.ShaderCacheDir.generic_u8string(); }, [](RuntimeOptions& opts, const std::string& val) { opts.ShaderCacheDir = val; })
+        .def_property(
+            "SceneCacheDir", [](const RuntimeOptions& opts) { return opts.SceneCacheDir.generic_u8string(); }, [](RuntimeOptions& opts, const std::string& val) { opts.SceneCacheDir = val; });
 
     py::class_<RuntimeRenderSettings>(m, "RuntimeRenderSettings")
         .def(py::init([]() { return RuntimeRenderSettings(); }))
@@ -127,8 +138,13 @@ PYBIND11_MODULE(pyignis, m)
         })
         .def("clearFramebuffer", py::overload_cast<>(&Runtime::clearFramebuffer))
         .def("clearFramebuffer", py::overload_cast<size_t>(&Runtime::clearFramebuffer))
+        .def("setMaterialParameter", py::overload_cast<const std::string&, float>(&Runtime::setMaterialParameter))
+        .def("setMaterialParameter", py::overload_cast<const std::string&, const Vector3f&>(&Runtime::setMaterialParameter))
+        .def_property_readonly("materialParameters", &Runtime::getMaterialParameterNames)
+        .def("getStatisticsAsJSON", &Runtime::getStatisticsAsJSON, py::arg("totalMS") = 0)
         .def_property_readonly("iterationCount", &Runtime::currentIterationCount)
         .def_property_readonly("sampleCount", &Runtime::currentSampleCount)
+        .def_property_readonly("activePixelCount", &Runtime::activePixelCount)
         .def_property_readonly("framebufferWidth", &Runtime::framebufferWidth)
         .def_property_readonly("framebufferHeight", &Runtime::framebufferHeight);
 
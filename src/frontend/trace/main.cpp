@@ -2,6 +2,7 @@
 #include "ProgramOptions.h"
 #include "Runtime.h"
 #include "config/Build.h"
+#include "serialization/MappedFile.h"
 
 #include <fstream>
 #include <iterator>
@@ -9,6 +10,9 @@
 
 #ifndef IG_OS_WINDOWS
 #include <unistd.h>
+#else
+#include <fcntl.h>
+#include <io.h>
 #endif
 
 using namespace IG;
@@ -60,12 +64,126 @@ static std::vector<Ray> read_input(std::istream& is, bool print_prefix)
     return rays;
 }
 
+static_assert(sizeof(Ray) == 8 * sizeof(float), "Expected a ray to be given by 8 floats");
+
+// Reads a single batch in the form [count:uint64][count x Ray]
+static std::vector<Ray> read_binary_input(std::istream& is)
+{
+    // The rays are traced in a single framebuffer row, the width of which is limited
+    constexpr uint64 MaxCount  = (uint64)std::numeric_limits<int32>::max();
+    constexpr size_t ChunkSize = 1 << 16; // Number of rays read at once, such that a corrupt header does not allocate more memory than the given data
+
+    uint64 count = 0;
+    if (!is.read(reinterpret_cast<char*>(&count), sizeof(count)))
+        return {};
+
+    if (count > MaxCount) {
+        IG_LOG(L_ERROR) << "Invalid batch header: " << count << " rays exceed the maximum of " << MaxCount << " rays per batch" << std::endl;
+        return {};
+    }
+
+    std::vector<Ray> rays;
+    while (rays.size() < count) {
+        const size_t offset = rays.size();
+        const size_t chunk  = std::min<size_t>(ChunkSize, count - offset);
+        rays.resize(offset + chunk);
+        if (!is.read(reinterpret_cast<char*>(rays.data() + offset), chunk * sizeof(Ray))) {
+            rays.resize(offset + is.gcount() / sizeof(Ray));
+            IG_LOG(L_ERROR) << "Expected " << count << " rays but got only " << rays.size() << std::endl;
+            break;
+        }
+    }
+
+    return rays;
+}
+
 static void write_output(std::ostream& is, const float* data, size_t count, size_t spp)
 {
     for (size_t i = 0; i < count; ++i)
         is << std::scientific << data[3 * i + 0] / spp << "\t" << data[3 * i + 1] / spp << "\t" << data[3 * i + 2] / spp << std::endl;
 }
 
+static void write_binary_output(std::ostream& os, const float* data, size_t count, size_t spp)
+{
+    std::vector<float> scaled(3 * count);
+    for (size_t i = 0; i < scaled.size(); ++i)
+        scaled[i] = data[i] / spp;
+
+    os.write(reinterpret_cast<const char*>(scaled.data()), sizeof(float) * scaled.size());
+    os.flush();
+}
+
+static size_t compute_iterations(const ProgramOptions& cmd, const Runtime& runtime)
+{
+    const size_t SPI          = runtime.samplesPerIteration();
+    const size_t desired_iter = std::max<size_t>(1, static_cast<size_t>(std::ceil(cmd.SPP.value_or(1) / (float)SPI)));
+
+    if (cmd.SPP.has_value() && (cmd.SPP.value() % SPI) != 0)
+        IG_LOG(L_WARNING) << "Given spp " << cmd.SPP.value() << " is not a multiple of the spi " << SPI << ". Using spp " << desired_iter * SPI << " instead" << std::endl;
+    return desired_iter;
+}
+
+// Traces all rays of a binary input file in chunks, which keeps the device memory bounded by the chunk size
+static int trace_chunked(const ProgramOptions& cmd, RuntimeOptions opts)
+{
+    MappedFile mapped;
+    if (!mapped.open(cmd.InputRay)) {
+        IG_LOG(L_ERROR) << "Could not open " << cmd.InputRay << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (mapped.size() % sizeof(Ray) != 0)
+        IG_LOG(L_WARNING) << "Size of " << cmd.InputRay << " is not a multiple of a ray record. Ignoring the remaining bytes" << std::endl;
+    const Ray* rays        = reinterpret_cast<const Ray*>(mapped.data());
+    const size_t ray_count = mapped.size() / sizeof(Ray);
+
+    if (ray_count == 0) {
+        IG_LOG(L_ERROR) << "No rays given" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const size_t chunk_size = std::min(cmd.ChunkSize, ray_count);
+    opts.OverrideFilmSize   = { (uint32)chunk_size, 1 };
+
+    std::unique_ptr<Runtime> runtime;
+    try {
+        runtime = std::make_unique<Runtime>(opts);
+    } catch (const std::exception& e) {
+        IG_LOG(L_ERROR) << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!runtime->loadFromFile(cmd.InputScene)) {
+        IG_LOG(L_ERROR) << "Could not load " << cmd.InputScene << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const size_t desired_iter = compute_iterations(cmd, *runtime);
+
+    std::ofstream file;
+    if (!cmd.Output.empty())
+        file.open(cmd.Output, std::ofstream::out | std::ofstream::binary);
+    std::ostream& output = cmd.Output.empty() ? std::cout : file;
+
+    // The source is called on a worker thread, but never concurrently
+    size_t offset     = 0;
+    const auto source = [&](Ray* chunk, size_t capacity) {
+        const size_t count = std::min(capacity, ray_count - offset);
+        std::copy(rays + offset, rays + offset + count, chunk);
+        offset += count;
+        return count;
+    };
+    const auto sink = [&](const float* data, size_t count) { write_binary_output(output, data, count, runtime->currentIterationCount()); };
+
+    const size_t traced = runtime->traceStream(source, sink, chunk_size, desired_iter, cmd.NormalizedRays);
+    if (traced != ray_count) {
+        IG_LOG(L_ERROR) << "Traced " << traced << " rays but expected " << ray_count << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
 int main(int argc, char** argv)
 {
     ProgramOptions cmd(argc, argv, ApplicationType::Trace, "Command Line Tracer");
@@ -90,45 +208,82 @@ int main(int argc, char** argv)
     const bool isInteractive = cmd.InputRay.empty();
     bool firstRound          = true;
 
+#ifdef IG_OS_WINDOWS
+    if (cmd.BinaryRayIO) {
+        _setmode(_fileno(stdin), _O_BINARY);
+        _setmode(_fileno(stdout), _O_BINARY);
+    }
+#endif
+
+    if (cmd.ChunkSize > 0) {
+        if (cmd.BinaryRayIO && !isInteractive)
+            return trace_chunked(cmd, opts);
+        IG_LOG(L_WARNING) << "Ignoring the chunk size, as it is only supported for binary input files" << std::endl;
+    }
+
+    // The runtime is kept alive between batches, such that the scene and the compiled shaders stay resident
+    std::unique_ptr<Runtime> runtime;
+    size_t desired_iter = 1;
+
     while (true) {
         std::vector<Ray> rays;
-        if (isInteractive) {
+        MappedFile mapped; // Binary files are mapped and used without any copy
+        const Ray* ray_data = nullptr;
+        size_t ray_count    = 0;
+        if (cmd.BinaryRayIO) {
+            if (isInteractive) {
+                rays = read_binary_input(std::cin);
+            } else if (mapped.open(cmd.InputRay)) {
+                if (mapped.size() % sizeof(Ray) != 0)
+                    IG_LOG(L_WARNING) << "Size of " << cmd.InputRay << " is not a multiple of a ray record. Ignoring the remaining bytes" << std::endl;
+                ray_data  = reinterpret_cast<const Ray*>(mapped.data());
+                ray_count = mapped.size() / sizeof(Ray);
+            }
+        } else if (isInteractive) {
             rays = read_input(std::cin, isAtty);
         } else {
             std::ifstream stream(cmd.InputRay);
             rays = read_input(stream, false);
         }
 
-        if (rays.empty()) {
-            if (firstRound || !isInteractive)
-                IG_LOG(L_ERROR) << "No rays given" << std::endl;
-            return EXIT_FAILURE;
+        if (ray_data == nullptr) {
+            ray_data  = rays.data();
+            ray_count = rays.size();
         }
 
-        opts.OverrideFilmSize = { (uint32)rays.size(), 1 };
-        std::unique_ptr<Runtime> runtime;
-        try {
-            runtime = std::make_unique<Runtime>(opts);
-        } catch (const std::exception& e) {
-            IG_LOG(L_ERROR) << e.what() << std::endl;
-            return EXIT_FAILURE;
+        if (ray_count == 0) {
+            if (firstRound || !isInteractive) {
+                IG_LOG(L_ERROR) << "No rays given" << std::endl;
+                return EXIT_FAILURE;
+            }
+            break; // End of input
         }
 
-        if (!runtime->loadFromFile(cmd.InputScene)) {
-            IG_LOG(L_ERROR) << "Could not load " << cmd.InputScene << std::endl;
-            return EXIT_FAILURE;
+        if (!runtime) {
+            opts.OverrideFilmSize = { (uint32)ray_count, 1 };
+            try {
+                runtime = std::make_unique<Runtime>(opts);
+            } catch (const std::exception& e) {
+                IG_LOG(L_ERROR) << e.what() << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            if (!runtime->loadFromFile(cmd.InputScene)) {
+                IG_LOG(L_ERROR) << "Could not load " << cmd.InputScene << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            desired_iter = compute_iterations(cmd, *runtime);
+        } else {
+            // Start a new accumulation for the new batch
+            runtime->reset();
         }
 
-        const size_t SPI          = runtime->samplesPerIteration();
-        const size_t desired_iter = std::max<size_t>(1, static_cast<size_t>(std::ceil(cmd.SPP.value_or(1) / (float)SPI)));
-
-        if (cmd.SPP.has_value() && (cmd.SPP.value() % SPI) != 0)
-            IG_LOG(L_WARNING) << "Given spp " << cmd.SPP.value() << " is not a multiple of the spi " << SPI << ". Using spp " << desired_iter * SPI << " instead" << std::endl;
-
         std::vector<float> accum_data;
         std::vector<float> iter_data;
         for (size_t iter = 0; iter < desired_iter; ++iter) {
-            runtime->trace(rays, iter_data);
+            // Upload the rays of the batch once, all iterations trace the same rays
+            runtime->trace(ray_data, ray_count, iter_data, cmd.NormalizedRays, iter > 0);
 
             if (accum_data.size() != iter_data.size())
                 accum_data.resize(iter_data.size(), 0.0f);
@@ -136,21 +291,26 @@ int main(int argc, char** argv)
                 accum_data[i] = iter_data[i];
         }
 
-        if (accum_data.size() != rays.size() * 3) {
-            IG_LOG(L_FATAL) << "Got trace output size " << accum_data.size() << " but expected " << rays.size() * 3 << std::endl;
+        if (accum_data.size() != ray_count * 3) {
+            IG_LOG(L_FATAL) << "Got trace output size " << accum_data.size() << " but expected " << ray_count * 3 << std::endl;
             return EXIT_FAILURE;
         }
 
         // Extract data
+        const auto write = cmd.BinaryRayIO ? write_binary_output : write_output;
         if (cmd.Output.empty()) {
-            write_output(std::cout, accum_data.data(), rays.size(), runtime->currentIterationCount());
+            write(std::cout, accum_data.data(), ray_count, runtime->currentIterationCount());
         } else {
-            std::ofstream stream(cmd.Output, firstRound ? std::ofstream::out : (std::ofstream::out | std::ofstream::app));
-            write_output(stream, accum_data.data(), rays.size(), runtime->currentIterationCount());
+            auto mode = firstRound ? std::ofstream::out : (std::ofstream::out | std::ofstream::app);
+            if (cmd.BinaryRayIO)
+                mode |= std::ofstream::binary;
+            std::ofstream stream(cmd.Output, mode);
+            write(stream, accum_data.data(), ray_count, runtime->currentIterationCount());
         }
 
+        // Batches from the standard input are separated by empty lines, which allows other processes to pipe queries continuously
         firstRound = false;
-        if (!isInteractive || !isAtty)
+        if (!isInteractive)
             break;
     }
 
@@ -242,6 +242,13 @@ int main(int argc, char** argv)
             << "    Saving>  " << beautiful_time(timer_saving.duration_ms) << std::endl;
     }
 
+    if (!cmd.StatsFile.empty()) {
+        if (!saveStatisticsOutput(cmd.StatsFile, *runtime, timer_render.duration_ms))
+            IG_LOG(L_ERROR) << "Failed to save statistics to " << cmd.StatsFile << std::endl;
+        else
+            IG_LOG(L_INFO) << "Statistics saved to " << cmd.StatsFile << std::endl;
+    }
+
     runtime.reset();
 
     if (!samples_stats.empty())
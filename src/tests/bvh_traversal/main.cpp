@@ -0,0 +1,302 @@
+#include "Logger.h"
+#include "bvh/TriBVHAdapter.h"
+#include "math/Tangent.h"
+#include "mesh/ObjFile.h"
+#include "mesh/PlyFile.h"
+#include "serialization/MappedFile.h"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+
+#include "generated_bench_interface.h"
+
+#include "BenchCommon.h"
+
+using namespace IG;
+
+// Same layout as the rays given to igtrace: origin, direction, tmin and tmax
+struct BenchRay {
+    StVector3f Origin;
+    StVector3f Direction;
+    float TMin;
+    float TMax;
+};
+static_assert(sizeof(BenchRay) == 8 * sizeof(float), "Expected a ray to be given by 8 floats");
+
+static void append_mesh(TriMesh& dst, const TriMesh& src)
+{
+    const uint32 offset = (uint32)dst.vertices.size();
+    dst.vertices.insert(dst.vertices.end(), src.vertices.begin(), src.vertices.end());
+    for (size_t i = 0; i < src.indices.size(); ++i)
+        dst.indices.push_back((i % 4) == 3 ? 0 : src.indices[i] + offset);
+}
+
+// Grid of spheres inside a closed box, such that bounce rays hit something as well
+static TriMesh make_synthetic_mesh()
+{
+    TriMesh mesh = TriMesh::MakeBox(Vector3f(-6, -6, -6), Vector3f(12, 0, 0), Vector3f(0, 12, 0), Vector3f(0, 0, 12));
+    for (int x = -2; x <= 2; ++x) {
+        for (int y = -2; y <= 2; ++y) {
+            for (int z = -2; z <= 2; ++z)
+                append_mesh(mesh, TriMesh::MakeIcoSphere(Vector3f(x * 2.0f, y * 2.0f, z * 2.0f), 0.7f, 4));
+        }
+    }
+    return mesh;
+}
+
+struct SurfacePoint {
+    Vector3f Position;
+    Vector3f Normal;
+};
+
+static SurfacePoint sample_surface(const TriMesh& mesh, BenchRandom& rnd)
+{
+    const size_t face = std::min(mesh.faceCount() - 1, (size_t)(rnd.next() * mesh.faceCount()));
+    const Vector3f p0 = mesh.vertices[mesh.indices[face * 4 + 0]];
+    const Vector3f p1 = mesh.vertices[mesh.indices[face * 4 + 1]];
+    const Vector3f p2 = mesh.vertices[mesh.indices[face * 4 + 2]];
+
+    float u = rnd.next();
+    float v = rnd.next();
+    if (u + v > 1) {
+        u = 1 - u;
+        v = 1 - v;
+    }
+
+    return SurfacePoint{ p0 + u * (p1 - p0) + v * (p2 - p0), (p1 - p0).cross(p2 - p0).normalized() };
+}
+
+// Coherent rays from a pinhole camera looking at the center of the mesh
+static std::vector<BenchRay> make_camera_rays(const TriMesh& mesh, size_t count)
+{
+    BoundingBox bbox = BoundingBox::Empty();
+    for (const auto& v : mesh.vertices)
+        bbox.extend(v);
+
+    const Vector3f eye    = bbox.center() - Vector3f(0, 0, bbox.diameter().z() * 0.45f);
+    const size_t width    = std::max<size_t>(1, (size_t)std::sqrt((double)count));
+    const size_t height   = (count + width - 1) / width;
+    const float tan_fov_2 = std::tan(30.0f * Deg2Rad);
+
+    std::vector<BenchRay> rays(count);
+    for (size_t i = 0; i < count; ++i) {
+        const float x = (2 * ((i % width) + 0.5f) / width - 1) * tan_fov_2;
+        const float y = (2 * ((i / width) + 0.5f) / height - 1) * tan_fov_2;
+        rays[i]       = BenchRay{ eye, Vector3f(x, y, 1).normalized(), 0, std::numeric_limits<float>::max() };
+    }
+    return rays;
+}
+
+// Incoherent rays leaving the surface in a cosine weighted direction
+static std::vector<BenchRay> make_diffuse_rays(const TriMesh& mesh, size_t count)
+{
+    BenchRandom rnd(1);
+    std::vector<BenchRay> rays(count);
+    for (size_t i = 0; i < count; ++i) {
+        const SurfacePoint point = sample_surface(mesh, rnd);
+
+        const float phi = 2 * Pi * rnd.next();
+        const float r2  = rnd.next();
+        const float r   = std::sqrt(r2);
+
+        Vector3f tx, ty;
+        Tangent::frame(point.Normal, tx, ty);
+        const Vector3f dir = (r * std::cos(phi) * tx + r * std::sin(phi) * ty + std::sqrt(1 - r2) * point.Normal).normalized();
+
+        // Both sides of the surface are used, as the normals of the box point outside
+        const float side = rnd.next() < 0.5f ? 1.0f : -1.0f;
+        rays[i]          = BenchRay{ point.Position, side * dir, 1e-4f, std::numeric_limits<float>::max() };
+    }
+    return rays;
+}
+
+// Rays between the surface and a point light in the center of the box, terminating just before the light
+static std::vector<BenchRay> make_shadow_rays(const TriMesh& mesh, size_t count)
+{
+    BoundingBox bbox = BoundingBox::Empty();
+    for (const auto& v : mesh.vertices)
+        bbox.extend(v);
+    const Vector3f light = bbox.center() + Vector3f(0.5f, 0.5f, 0.5f); // Not inside a sphere
+
+    BenchRandom rnd(2);
+    std::vector<BenchRay> rays(count);
+    for (size_t i = 0; i < count; ++i) {
+        const SurfacePoint point = sample_surface(mesh, rnd);
+        const Vector3f delta     = light - point.Position;
+        const float dist         = delta.norm();
+        rays[i]                  = BenchRay{ point.Position, delta / dist, 1e-4f, dist * (1 - 1e-4f) };
+    }
+    return rays;
+}
+
+// Reads rays in one of the binary forms accepted by igtrace --binary until the file ends or enough rays are loaded.
+// Files given to igtrace by --input are a plain sequence of rays without any header.
+// If batched is true, the file contains batches in the form [count:uint64][count x Ray] as given to igtrace on stdin instead
+static std::vector<BenchRay> load_rays(const std::filesystem::path& path, size_t max_count, bool batched)
+{
+    MappedFile mapped;
+    if (!mapped.open(path)) {
+        IG_LOG(L_ERROR) << "Could not open " << path << std::endl;
+        return {};
+    }
+
+    if (!batched) {
+        if (mapped.size() % sizeof(BenchRay) != 0)
+            IG_LOG(L_WARNING) << "Size of " << path << " is not a multiple of a ray record. Ignoring the remaining bytes" << std::endl;
+
+        const size_t taken = std::min(max_count, mapped.size() / sizeof(BenchRay));
+        const auto* data   = reinterpret_cast<const BenchRay*>(mapped.data());
+        return std::vector<BenchRay>(data, data + taken);
+    }
+
+    std::vector<BenchRay> rays;
+    size_t offset = 0;
+    while (offset + sizeof(uint64) <= mapped.size() && rays.size() < max_count) {
+        uint64 count = 0;
+        std::memcpy(&count, mapped.data() + offset, sizeof(count));
+        offset += sizeof(count);
+
+        const size_t available = std::min<size_t>(count, (mapped.size() - offset) / sizeof(BenchRay));
+        const size_t taken     = std::min(available, max_count - rays.size());
+        const auto* data       = reinterpret_cast<const BenchRay*>(mapped.data() + offset);
+        rays.insert(rays.end(), data, data + taken);
+        offset += available * sizeof(BenchRay);
+
+        if (available < count) {
+            IG_LOG(L_WARNING) << "Expected " << count << " rays but got only " << available << std::endl;
+            break;
+        }
+    }
+
+    return rays;
+}
+
+// The traversal expects normalized directions and a valid range
+static void sanitize_rays(std::vector<BenchRay>& rays)
+{
+    for (auto& ray : rays) {
+        ray.Direction = Vector3f(ray.Direction).normalized();
+        if (ray.TMax <= ray.TMin)
+            ray.TMax = std::numeric_limits<float>::max();
+    }
+}
+
+struct BvhData {
+    size_t Arity;
+    std::vector<uint8> Nodes;
+    std::vector<uint8> Tris;
+};
+
+template <size_t N>
+static BvhData build_bvh_data(const TriMesh& mesh)
+{
+    std::vector<typename BvhNTriM<N, 4>::Node> nodes;
+    std::vector<typename BvhNTriM<N, 4>::Tri> tris;
+    build_bvh<N, 4, std::allocator>(mesh, nodes, tris);
+
+    BvhData data;
+    data.Arity = N;
+    data.Nodes.resize(nodes.size() * sizeof(nodes[0]));
+    data.Tris.resize(tris.size() * sizeof(tris[0]));
+    std::memcpy(data.Nodes.data(), nodes.data(), data.Nodes.size());
+    std::memcpy(data.Tris.data(), tris.data(), data.Tris.size());
+    return data;
+}
+
+struct BenchResult {
+    double MRaysPerSecond; // Median over all repetitions
+    size_t HitCount;
+};
+
+static BenchResult run_traversal(BvhData& bvh, std::vector<BenchRay>& rays, int vector_width, bool any_hit, size_t repetitions)
+{
+    const auto traverse = bvh.Arity == 8 ? ig_bench_traverse_bvh8 : ig_bench_traverse_bvh4;
+
+    std::vector<int32_t> hits(rays.size());
+    const double mrays = measure_median_mrays(
+        rays.size(), repetitions, [] {},
+        [&] { traverse(bvh.Nodes.data(), bvh.Tris.data(), reinterpret_cast<float*>(rays.data()), hits.data(), (int32_t)rays.size(), vector_width, any_hit ? 1 : 0); });
+
+    const size_t hit_count = std::count_if(hits.begin(), hits.end(), [](int32_t id) { return id != -1; });
+    return BenchResult{ mrays, hit_count };
+}
+
+// This application measures the CPU traversal kernels in isolation from shading for different BVH arities and vector widths.
+// The vector widths correspond to the generic (1), sse42/asimd (4) and avx/avx2 (8) targets.
+// Recorded rays are given by --rays in the headerless form of igtrace --binary --input or by --ray-batches in the batched form of igtrace --binary on stdin.
+// Usage: [-n count] [-r repetitions] [--rays file|--ray-batches file] [mesh.obj|mesh.ply]
+int main(int argc, char** argv)
+{
+    BenchOptions options{ 1 << 20, 5 };
+    std::filesystem::path mesh_file;
+    std::filesystem::path ray_file;
+    bool batched_rays = false;
+
+    parse_bench_arguments(argc, argv, options, [&](const std::string& arg, const char* value) {
+        if ((arg == "--rays" || arg == "--ray-batches") && value) {
+            ray_file     = value;
+            batched_rays = arg == "--ray-batches";
+            return true;
+        }
+        mesh_file = arg;
+        return false;
+    });
+    const size_t count       = options.Count;
+    const size_t repetitions = options.Repetitions;
+
+    TriMesh mesh;
+    if (mesh_file.empty())
+        mesh = make_synthetic_mesh();
+    else if (mesh_file.extension() == ".ply")
+        mesh = ply::load(mesh_file);
+    else
+        mesh = obj::load(mesh_file);
+
+    if (mesh.faceCount() == 0) {
+        IG_LOG(L_ERROR) << "Empty mesh given" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::pair<std::string, std::vector<BenchRay>>> ray_sets;
+    ray_sets.emplace_back("camera", make_camera_rays(mesh, count));
+    ray_sets.emplace_back("diffuse", make_diffuse_rays(mesh, count));
+    ray_sets.emplace_back("shadow", make_shadow_rays(mesh, count));
+    if (!ray_file.empty()) {
+        auto rays = load_rays(ray_file, count, batched_rays);
+        if (rays.empty())
+            return EXIT_FAILURE;
+        ray_sets.emplace_back("recorded", std::move(rays));
+    }
+
+    for (auto& set : ray_sets)
+        sanitize_rays(set.second);
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    std::vector<BvhData> bvhs;
+    bvhs.push_back(build_bvh_data<4>(mesh));
+    bvhs.push_back(build_bvh_data<8>(mesh));
+    IG_LOG(L_INFO) << "Building BVHs for " << mesh.faceCount() << " triangles took " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start).count() / 1000.0f << " seconds" << std::endl;
+
+    std::cout << std::left << std::setw(10) << "Rays" << std::setw(8) << "BVH" << std::setw(8) << "Width" << std::setw(18) << "Closest [Mrays/s]" << std::setw(14) << "Any [Mrays/s]" << "Hits" << std::endl;
+    for (auto& set : ray_sets) {
+        for (auto& bvh : bvhs) {
+            for (int vector_width : { 1, 4, 8 }) {
+                const BenchResult closest = run_traversal(bvh, set.second, vector_width, false, repetitions);
+                const BenchResult any     = run_traversal(bvh, set.second, vector_width, true, repetitions);
+
+                // Any hit may stop at another primitive, but has to agree on whether something was hit at all
+                if (closest.HitCount != any.HitCount) {
+                    IG_LOG(L_ERROR) << "Closest hit and any hit traversal disagree for " << set.first << " rays: " << closest.HitCount << " != " << any.HitCount << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                std::cout << std::left << std::setw(10) << set.first << std::setw(8) << ("BVH" + std::to_string(bvh.Arity)) << std::setw(8) << vector_width
+                          << std::fixed << std::setprecision(2) << std::setw(18) << closest.MRaysPerSecond << std::setw(14) << any.MRaysPerSecond
+                          << closest.HitCount << std::endl;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
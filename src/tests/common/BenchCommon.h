@@ -0,0 +1,81 @@
+#pragma once
+
+#include "IG_Config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Helpers shared by the standalone benchmarks in src/tests
+namespace IG {
+// Cheap and deterministic random numbers
+class BenchRandom {
+public:
+    explicit BenchRandom(uint32 seed)
+        : mState(seed * 2654435761u + 1)
+    {
+    }
+
+    /// Random number with 24 bits
+    inline uint32 nextUInt()
+    {
+        mState = mState * 1664525u + 1013904223u;
+        return mState >> 8;
+    }
+
+    /// Random number in [0, 1)
+    inline float next() { return nextUInt() * (1.0f / 16777216.0f); }
+
+private:
+    uint32 mState;
+};
+
+/// Options shared by all benchmarks
+struct BenchOptions {
+    size_t Count;       // Number of rays
+    size_t Repetitions; // Number of measured runs, the median of which is reported
+};
+
+/// Parses -n count and -r repetitions. All other arguments are given to the handler together with the following argument, which is null if none is available.
+/// The handler returns true if it consumed the following argument
+template <typename Func>
+inline void parse_bench_arguments(int argc, char** argv, BenchOptions& options, const Func& handler)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const char* value     = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "-n" && value) {
+            options.Count = std::max(1, std::atoi(value));
+            ++i;
+        } else if (arg == "-r" && value) {
+            options.Repetitions = std::max(1, std::atoi(value));
+            ++i;
+        } else if (handler(arg, value)) {
+            ++i;
+        }
+    }
+}
+
+/// Runs the function once to warm up and then for the given number of repetitions. The setup is called before each run and is not part of the measured time.
+/// Returns the median throughput in million rays per second
+template <typename SetupFunc, typename Func>
+inline double measure_median_mrays(size_t rayCount, size_t repetitions, const SetupFunc& setup, const Func& func)
+{
+    std::vector<double> rays_sec;
+    for (size_t i = 0; i < repetitions + 1 /* Warm up */; ++i) {
+        setup();
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        func();
+        const double elapsed_sec = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        if (i > 0)
+            rays_sec.push_back(rayCount / std::max(elapsed_sec, 1e-9) * 1e-6);
+    }
+
+    std::sort(rays_sec.begin(), rays_sec.end());
+    return rays_sec[rays_sec.size() / 2];
+}
+} // namespace IG
@@ -0,0 +1,216 @@
+#include "Logger.h"
+
+#include <cstring>
+#include <functional>
+#include <iomanip>
+
+#include "generated_bench_interface.h"
+
+#include "BenchCommon.h"
+#include "StreamLayout.h"
+
+using namespace IG;
+
+// Stream with its own storage, similar to the streams given by the driver
+class BenchStream {
+public:
+    explicit BenchStream(size_t capacity)
+        : mData(capacity * PrimaryStreamSize)
+    {
+        auto r_ptr = reinterpret_cast<float**>(&mStream);
+        for (size_t i = 0; i < PrimaryStreamSize; ++i)
+            r_ptr[i] = mData.data() + i * capacity;
+        mStream.size = 0;
+    }
+
+    inline PrimaryStream* stream() { return &mStream; }
+    inline const PrimaryStream* stream() const { return &mStream; }
+    inline size_t size() const { return (size_t)mStream.size; }
+    inline const std::vector<float>& data() const { return mData; }
+
+    inline void assign(const BenchStream& other)
+    {
+        std::memcpy(mData.data(), other.mData.data(), mData.size() * sizeof(float));
+        mStream.size = other.mStream.size;
+    }
+
+private:
+    std::vector<float> mData;
+    PrimaryStream mStream;
+};
+
+// Hits are distributed uniformly over all entities, with a share of misses. The misses use the id after the last entity
+static void fill_stream(BenchStream& stream, size_t count, int32_t num_bins, float miss_ratio)
+{
+    BenchRandom rnd(42);
+
+    PrimaryStream* primary = stream.stream();
+    for (size_t i = 0; i < count; ++i) {
+        const bool miss    = rnd.next() < miss_ratio;
+        primary->ent_id[i] = miss ? num_bins : (int32_t)(rnd.nextUInt() % (uint32)num_bins);
+
+        // Tag the entry with its original position, such that the payload can be checked after sorting
+        primary->prim_id[i]   = (int32_t)i;
+        primary->user.e[0][i] = (float)i;
+    }
+    primary->size = (int32_t)count;
+}
+
+// Maps an entity id to the bin it is sorted into. Misses are mapped to the bin after the last one
+using SortKey = std::function<int32_t(int32_t)>;
+
+struct BenchResult {
+    double MRaysPerSecond; // Median over all repetitions
+    int32_t HitCount;
+    std::vector<int32_t> RayEnds;
+};
+
+// Checks if the hits are sorted by the key into the expected bins, the payload moved together with the entity id and all misses are behind the hits
+static bool check_sorted(const PrimaryStream* sorted, const PrimaryStream* original, const BenchResult& result, int32_t num_bins, const SortKey& key)
+{
+    std::vector<int32_t> ray_ends(num_bins + 1, 0);
+    for (int32_t i = 0; i < original->size; ++i)
+        ray_ends[key(original->ent_id[i])]++;
+    for (int32_t i = 1; i <= num_bins; ++i)
+        ray_ends[i] += ray_ends[i - 1];
+
+    if (result.RayEnds != ray_ends || result.HitCount != ray_ends[num_bins - 1])
+        return false;
+
+    int32_t bin = 0;
+    for (int32_t i = 0; i < original->size; ++i) {
+        while (i >= ray_ends[bin])
+            ++bin;
+
+        const int32_t org = sorted->prim_id[i];
+        if (key(sorted->ent_id[i]) != bin)
+            return false;
+        if (org < 0 || org >= original->size || original->ent_id[org] != sorted->ent_id[i] || sorted->user.e[0][i] != (float)org)
+            return false;
+    }
+    return true;
+}
+
+static bool check_keys(const std::vector<int32_t>& keys, const PrimaryStream* original, int32_t hit_count)
+{
+    for (int32_t i = 1; i < hit_count; ++i) {
+        if (original->ent_id[keys[i - 1]] > original->ent_id[keys[i]])
+            return false;
+    }
+    return true;
+}
+
+// The input is restored before each sort, which is not part of the measured time
+template <typename Func>
+static BenchResult run_sort(BenchStream& work, const BenchStream& input, int32_t num_bins, size_t repetitions, const Func& func)
+{
+    std::vector<int32_t> ray_begins(num_bins + 1);
+    std::vector<int32_t> ray_ends(num_bins + 1);
+
+    int32_t hit_count  = 0;
+    const double mrays = measure_median_mrays(
+        input.size(), repetitions, [&] { work.assign(input); },
+        [&] { hit_count = func(work.stream(), ray_begins.data(), ray_ends.data()); });
+
+    return BenchResult{ mrays, hit_count, ray_ends };
+}
+
+// This application measures the sorting of primary streams by entity in isolation from traversal and shading.
+// It compares the in-place sort, the out-of-place sort into a second stream and a sort of the keys only.
+// Additionally, the in-place and out-of-place sort by the material of the entities is measured, with the entities spread evenly over the materials.
+// Usage: [-n count] [-r repetitions] [-b bins] [-k materials] [-m miss_ratio]
+int main(int argc, char** argv)
+{
+    BenchOptions options{ 1 << 16, 21 };
+    int32_t num_bins      = 64;
+    int32_t num_materials = 0; // Quarter of the entities by default
+    float miss_ratio      = 0.1f;
+
+    parse_bench_arguments(argc, argv, options, [&](const std::string& arg, const char* value) {
+        if (arg == "-b" && value) {
+            num_bins = std::max(1, std::atoi(value));
+            return true;
+        } else if (arg == "-k" && value) {
+            num_materials = std::max(1, std::atoi(value));
+            return true;
+        } else if (arg == "-m" && value) {
+            miss_ratio = std::min(1.0f, std::max(0.0f, (float)std::atof(value)));
+            return true;
+        }
+        IG_LOG(L_WARNING) << "Unknown argument " << arg << std::endl;
+        return false;
+    });
+    const size_t count       = options.Count;
+    const size_t repetitions = options.Repetitions;
+    if (num_materials == 0)
+        num_materials = std::max(1, num_bins / 4);
+
+    // Neighbouring entities have different materials, such that the material sort differs from the entity sort
+    std::vector<int32_t> entity_to_material(num_bins);
+    for (int32_t i = 0; i < num_bins; ++i)
+        entity_to_material[i] = i % num_materials;
+
+    const SortKey entity_key   = [](int32_t ent_id) { return ent_id; };
+    const SortKey material_key = [&](int32_t ent_id) { return ent_id >= num_bins ? num_materials : entity_to_material[ent_id]; };
+
+    BenchStream input(count);
+    BenchStream work(count);
+    BenchStream sorted(count);
+    std::vector<int32_t> keys(count);
+    fill_stream(input, count, num_bins, miss_ratio);
+
+    const BenchResult in_place = run_sort(work, input, num_bins, repetitions, [&](PrimaryStream* primary, int32_t* ray_begins, int32_t* ray_ends) {
+        return ig_bench_sort_in_place(primary, ray_begins, ray_ends, num_bins);
+    });
+    if (!check_sorted(work.stream(), input.stream(), in_place, num_bins, entity_key)) {
+        IG_LOG(L_ERROR) << "In-place sort produced an invalid stream" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const BenchResult out_of_place = run_sort(work, input, num_bins, repetitions, [&](PrimaryStream* primary, int32_t* ray_begins, int32_t* ray_ends) {
+        sorted.stream()->size = primary->size;
+        return ig_bench_sort_out_of_place(primary, sorted.stream(), ray_begins, ray_ends, num_bins);
+    });
+    if (!check_sorted(sorted.stream(), input.stream(), out_of_place, num_bins, entity_key)) {
+        IG_LOG(L_ERROR) << "Out-of-place sort produced an invalid stream" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const BenchResult key_only = run_sort(work, input, num_bins, repetitions, [&](PrimaryStream* primary, int32_t* ray_begins, int32_t* ray_ends) {
+        return ig_bench_sort_keys(primary, keys.data(), ray_begins, ray_ends, num_bins);
+    });
+    if (!check_keys(keys, input.stream(), key_only.HitCount)) {
+        IG_LOG(L_ERROR) << "Key sort produced an invalid permutation" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // All variants have to agree on the bins
+    if (in_place.RayEnds != out_of_place.RayEnds || in_place.RayEnds != key_only.RayEnds) {
+        IG_LOG(L_ERROR) << "Sort variants disagree on the entity bins" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const BenchResult material_in_place = run_sort(work, input, num_materials, repetitions, [&](PrimaryStream* primary, int32_t* ray_begins, int32_t* ray_ends) {
+        return ig_bench_sort_material_in_place(primary, entity_to_material.data(), num_bins, ray_begins, ray_ends, num_materials);
+    });
+    if (!check_sorted(work.stream(), input.stream(), material_in_place, num_materials, material_key)) {
+        IG_LOG(L_ERROR) << "In-place material sort produced an invalid stream" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const BenchResult material_out_of_place = run_sort(work, input, num_materials, repetitions, [&](PrimaryStream* primary, int32_t* ray_begins, int32_t* ray_ends) {
+        sorted.stream()->size = primary->size;
+        return ig_bench_sort_material_out_of_place(primary, sorted.stream(), entity_to_material.data(), num_bins, ray_begins, ray_ends, num_materials);
+    });
+    if (!check_sorted(sorted.stream(), input.stream(), material_out_of_place, num_materials, material_key)) {
+        IG_LOG(L_ERROR) << "Out-of-place material sort produced an invalid stream" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << std::left << std::setw(10) << "Rays" << std::setw(8) << "Bins" << std::setw(10) << "Hits" << std::setw(22) << "In-place [Mrays/s]" << std::setw(26) << "Out-of-place [Mrays/s]" << std::setw(18) << "Keys [Mrays/s]" << std::setw(30) << "Material in-place [Mrays/s]" << "Material out-of-place [Mrays/s]" << std::endl;
+    std::cout << std::left << std::setw(10) << count << std::setw(8) << num_bins << std::setw(10) << in_place.HitCount
+              << std::fixed << std::setprecision(2) << std::setw(22) << in_place.MRaysPerSecond << std::setw(26) << out_of_place.MRaysPerSecond
+              << std::setw(18) << key_only.MRaysPerSecond << std::setw(30) << material_in_place.MRaysPerSecond << material_out_of_place.MRaysPerSecond << std::endl;
+
+    return EXIT_SUCCESS;
+}
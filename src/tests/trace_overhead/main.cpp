@@ -0,0 +1,89 @@
+#include "Logger.h"
+#include "Runtime.h"
+
+#include <chrono>
+
+using namespace IG;
+
+using TimePoint = decltype(std::chrono::high_resolution_clock::now());
+static inline double elapsed_ms(const TimePoint& start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+static void fill_rays(std::vector<Ray>& rays, const BoundingBox& bbox, size_t seed)
+{
+    const Vector3f center = bbox.center();
+    for (size_t i = 0; i < rays.size(); ++i) {
+        // Cheap, deterministic and different for every seed
+        const float t = static_cast<float>((i * 2654435761u + seed * 40503u) % 65536) / 65536.0f;
+        const float a = t * 2 * Pi;
+
+        Ray& ray      = rays[i];
+        ray.Origin    = center;
+        ray.Direction = Vector3f(std::cos(a), std::sin(a), t - 0.5f).normalized();
+        ray.Range     = Vector2f(0, std::numeric_limits<float>::max());
+    }
+}
+
+// This application measures the overhead of a single trace() call for different numbers of rays.
+// The first round traces the same rays repeatedly and reuses the uploaded rays. The second round changes the rays every call, which requires an upload.
+// The test is passed if it runs without problems, the timings are only informative
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        IG_LOG(L_ERROR) << "Expected a scene file" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const size_t repetitions = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+
+    std::unique_ptr<Runtime> runtime;
+    try {
+        RuntimeOptions opts;
+        opts.IsTracer = true;
+        opts.SPI      = 1;
+        runtime       = std::make_unique<Runtime>(opts);
+    } catch (const std::exception& e) {
+        IG_LOG(L_ERROR) << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!runtime->loadFromFile(argv[1])) {
+        IG_LOG(L_ERROR) << "Failed loading" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<float> data;
+    for (size_t count : { (size_t)1, (size_t)1000, (size_t)1000000 }) {
+        std::vector<Ray> rays(count);
+        fill_rays(rays, runtime->sceneBoundingBox(), 0);
+
+        // Warm up, which includes the resize of the framebuffer
+        runtime->trace(rays, data);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < repetitions; ++i)
+            runtime->trace(rays.data(), rays.size(), data, false, true);
+        const double same_ms = elapsed_ms(start) / repetitions;
+
+        double changed_ms = 0;
+        for (size_t i = 0; i < repetitions; ++i) {
+            fill_rays(rays, runtime->sceneBoundingBox(), i + 1); // Not part of the measurement
+            start = std::chrono::high_resolution_clock::now();
+            runtime->trace(rays, data);
+            changed_ms += elapsed_ms(start);
+        }
+        changed_ms /= repetitions;
+
+        if (data.size() != count * 3) {
+            IG_LOG(L_ERROR) << "Got trace output size " << data.size() << " but expected " << count * 3 << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        IG_LOG(L_INFO) << count << " rays: " << same_ms << " ms per call with same rays, "
+                       << changed_ms << " ms per call with changed rays (" << (changed_ms * 1e6 / count) << " ns per ray)" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
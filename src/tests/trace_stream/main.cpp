@@ -0,0 +1,105 @@
+#include "Logger.h"
+#include "Runtime.h"
+
+#include <atomic>
+
+using namespace IG;
+
+static void fill_rays(std::vector<Ray>& rays, const BoundingBox& bbox)
+{
+    const Vector3f center = bbox.center();
+    for (size_t i = 0; i < rays.size(); ++i) {
+        // Cheap, deterministic and different for every ray
+        const float t = static_cast<float>((i * 2654435761u) % 65536) / 65536.0f;
+        const float a = t * 2 * Pi;
+
+        Ray& ray      = rays[i];
+        ray.Origin    = center;
+        ray.Direction = Vector3f(std::cos(a), std::sin(a), t - 0.5f).normalized();
+        ray.Range     = Vector2f(0, std::numeric_limits<float>::max());
+    }
+}
+
+// This application streams more rays than fit into a single chunk through traceStream() and checks that
+// the source is never called concurrently and the sink receives the result of every chunk in order.
+// The debug technique is used, as it is deterministic
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        IG_LOG(L_ERROR) << "Expected a scene file" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::unique_ptr<Runtime> runtime;
+    try {
+        RuntimeOptions opts;
+        opts.IsTracer          = true;
+        opts.SPI               = 1;
+        opts.OverrideTechnique = "debug";
+        runtime                = std::make_unique<Runtime>(opts);
+    } catch (const std::exception& e) {
+        IG_LOG(L_ERROR) << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!runtime->loadFromFile(argv[1])) {
+        IG_LOG(L_ERROR) << "Failed loading" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    constexpr size_t ChunkSize = 100;
+    constexpr size_t Count     = 5 * ChunkSize / 2; // The last chunk is only partially filled
+
+    std::vector<Ray> rays(Count);
+    fill_rays(rays, runtime->sceneBoundingBox());
+
+    // Stream all rays
+    size_t offset = 0;
+    std::atomic<int> active_sources{ 0 };
+    bool concurrent_source = false;
+    const auto source      = [&](Ray* chunk, size_t capacity) {
+        if (active_sources.fetch_add(1) != 0)
+            concurrent_source = true;
+
+        const size_t count = std::min(capacity, Count - offset);
+        std::copy(rays.begin() + offset, rays.begin() + offset + count, chunk);
+        offset += count;
+
+        active_sources.fetch_sub(1);
+        return count;
+    };
+
+    std::vector<size_t> chunk_sizes;
+    std::vector<float> streamed;
+    const auto sink = [&](const float* data, size_t count) {
+        chunk_sizes.push_back(count);
+        streamed.insert(streamed.end(), data, data + count * 3);
+    };
+
+    const size_t traced = runtime->traceStream(source, sink, ChunkSize);
+    if (traced != Count) {
+        IG_LOG(L_ERROR) << "Traced " << traced << " rays but expected " << Count << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (concurrent_source) {
+        IG_LOG(L_ERROR) << "Source was called concurrently" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (chunk_sizes != std::vector<size_t>{ ChunkSize, ChunkSize, Count - 2 * ChunkSize }) {
+        IG_LOG(L_ERROR) << "Sink received " << chunk_sizes.size() << " chunks, expected three chunks of sizes " << ChunkSize << ", " << ChunkSize << " and " << Count - 2 * ChunkSize << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // The streamed result has to be the same as tracing all rays at once, which is only the case if the chunks are given in order
+    std::vector<float> expected;
+    runtime->reset();
+    runtime->trace(rays, expected);
+    if (streamed != expected) {
+        IG_LOG(L_ERROR) << "Streamed result differs from tracing all rays at once" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
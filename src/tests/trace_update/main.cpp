@@ -0,0 +1,90 @@
+#include "Logger.h"
+#include "Runtime.h"
+
+using namespace IG;
+
+static void fill_rays(std::vector<Ray>& rays, const BoundingBox& bbox, size_t seed)
+{
+    const Vector3f center = bbox.center();
+    for (size_t i = 0; i < rays.size(); ++i) {
+        // Cheap, deterministic and different for every seed
+        const float t = static_cast<float>((i * 2654435761u + seed * 40503u) % 65536) / 65536.0f;
+        const float a = t * 2 * Pi;
+
+        Ray& ray      = rays[i];
+        ray.Origin    = center;
+        ray.Direction = Vector3f(std::cos(a), std::sin(a), t - 0.5f).normalized();
+        ray.Range     = Vector2f(0, std::numeric_limits<float>::max());
+    }
+}
+
+static std::vector<float> trace(Runtime& runtime, const std::vector<Ray>& rays, bool reuseRays = false)
+{
+    std::vector<float> data;
+    runtime.reset();
+    runtime.trace(rays.data(), rays.size(), data, false, reuseRays);
+    return data;
+}
+
+// This application checks that trace() uses the current content of the given rays, even if the array and the number of rays did not change.
+// The debug technique is used, as it is deterministic
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        IG_LOG(L_ERROR) << "Expected a scene file" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::unique_ptr<Runtime> runtime;
+    try {
+        RuntimeOptions opts;
+        opts.IsTracer          = true;
+        opts.SPI               = 1;
+        opts.OverrideTechnique = "debug";
+        runtime                = std::make_unique<Runtime>(opts);
+    } catch (const std::exception& e) {
+        IG_LOG(L_ERROR) << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!runtime->loadFromFile(argv[1])) {
+        IG_LOG(L_ERROR) << "Failed loading" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    constexpr size_t Count = 1000;
+    std::vector<Ray> rays(Count);
+
+    fill_rays(rays, runtime->sceneBoundingBox(), 0);
+    const std::vector<float> first = trace(*runtime, rays);
+
+    // Same vector, same number of rays, different content
+    fill_rays(rays, runtime->sceneBoundingBox(), 1);
+    const std::vector<float> second = trace(*runtime, rays);
+
+    if (first.size() != Count * 3 || second.size() != Count * 3) {
+        IG_LOG(L_ERROR) << "Got trace output size " << first.size() << " and " << second.size() << " but expected " << Count * 3 << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (first == second) {
+        IG_LOG(L_ERROR) << "Tracing different rays through the same array gave the same result. The rays were not uploaded again" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Reusing the uploaded rays has to give the same result as uploading them again
+    const std::vector<float> reused = trace(*runtime, rays, true);
+    if (reused != second) {
+        IG_LOG(L_ERROR) << "Reusing the uploaded rays changed the result" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Going back to the first rays gives the first result again
+    fill_rays(rays, runtime->sceneBoundingBox(), 0);
+    if (trace(*runtime, rays) != first) {
+        IG_LOG(L_ERROR) << "Tracing the first rays again gave a different result" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
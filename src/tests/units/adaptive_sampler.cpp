@@ -0,0 +1,109 @@
+#include "AdaptiveSampler.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+using namespace IG;
+
+// Small film with a constant left half and a noisy right half. Only active pixels receive new samples, like the driver does
+class TestFilm {
+public:
+    static constexpr size_t Width  = 16;
+    static constexpr size_t Height = 8;
+
+    TestFilm()
+        : Film(Width * Height * 3, 0.0f)
+        , AOV(Width * Height * 3, 0.0f)
+        , SecondMoment(Width * Height * 3, 0.0f)
+        , mState(1)
+    {
+    }
+
+    void render(const AdaptiveSampler& sampler)
+    {
+        for (size_t y = 0; y < Height; ++y) {
+            for (size_t x = 0; x < Width; ++x) {
+                if (!sampler.isActive(x, y))
+                    continue;
+
+                const float value = x < Width / 2 ? 0.5f : 1.0f + nextRandom();
+                for (size_t i = 0; i < 3; ++i) {
+                    Film[3 * (y * Width + x) + i] += value;
+                    AOV[3 * (y * Width + x) + i] += 1.0f;
+                }
+            }
+        }
+    }
+
+    std::vector<float> Film;
+    std::vector<float> AOV;
+    std::vector<float> SecondMoment;
+
+private:
+    inline float nextRandom()
+    {
+        mState = mState * 1664525u + 1013904223u;
+        return (mState >> 8) * (1.0f / 16777216.0f);
+    }
+
+    uint32 mState;
+};
+
+static void iterate(AdaptiveSampler& sampler, TestFilm& film, size_t iterations)
+{
+    for (size_t iter = 1; iter <= iterations; ++iter) {
+        film.render(sampler);
+        sampler.update(film.Film.data(), { film.AOV.data() }, film.SecondMoment.data(), iter);
+    }
+}
+
+TEST_CASE("All pixels are active during the warm-up", "[AdaptiveSampler]")
+{
+    AdaptiveSampler sampler(0.01f, 4);
+    sampler.resize(TestFilm::Width, TestFilm::Height);
+
+    TestFilm film;
+    iterate(sampler, film, 3);
+    CHECK(sampler.activePixelCount() == TestFilm::Width * TestFilm::Height);
+    CHECK(sampler.isActive(TileRegion{ 0, 0, 4, 4 }));
+    CHECK(sampler.isFullyActive(TileRegion{ 0, 0, (int32)TestFilm::Width, (int32)TestFilm::Height }));
+}
+
+TEST_CASE("Converged pixels stop sampling and keep their mean", "[AdaptiveSampler]")
+{
+    constexpr size_t Iterations = 16;
+
+    AdaptiveSampler sampler(0.01f, 4);
+    sampler.resize(TestFilm::Width, TestFilm::Height);
+
+    TestFilm film;
+    iterate(sampler, film, Iterations);
+
+    // Only the noisy half is still sampled
+    CHECK(sampler.activePixelCount() == TestFilm::Width * TestFilm::Height / 2);
+    CHECK_FALSE(sampler.isActive(0, 0));
+    CHECK(sampler.isActive(TestFilm::Width - 1, 0));
+    CHECK_FALSE(sampler.isActive(TileRegion{ 0, 0, (int32)TestFilm::Width / 2, (int32)TestFilm::Height }));
+    CHECK(sampler.isActive(TileRegion{ 0, 0, (int32)TestFilm::Width / 2 + 1, 1 }));
+    CHECK_FALSE(sampler.isFullyActive(TileRegion{ 0, 0, (int32)TestFilm::Width / 2 + 1, 1 }));
+    CHECK(sampler.isFullyActive(TileRegion{ (int32)TestFilm::Width / 2, 0, (int32)TestFilm::Width, (int32)TestFilm::Height }));
+
+    // Dividing by the iteration count still gives the mean of the converged pixels
+    CHECK_THAT(film.Film[0] / Iterations, Catch::Matchers::WithinRel(0.5f, 1e-5f));
+    CHECK_THAT(film.AOV[0] / Iterations, Catch::Matchers::WithinRel(1.0f, 1e-5f));
+    CHECK_THAT(AdaptiveSampler::relativeError(film.Film.data(), film.SecondMoment.data(), 0, Iterations), Catch::Matchers::WithinAbs(0.0f, 1e-3f));
+}
+
+TEST_CASE("Reset activates all pixels", "[AdaptiveSampler]")
+{
+    AdaptiveSampler sampler(0.01f, 2);
+    sampler.resize(TestFilm::Width, TestFilm::Height);
+
+    TestFilm film;
+    iterate(sampler, film, 4);
+    REQUIRE(sampler.activePixelCount() < TestFilm::Width * TestFilm::Height);
+
+    sampler.reset();
+    CHECK(sampler.activePixelCount() == TestFilm::Width * TestFilm::Height);
+    CHECK(sampler.isActive(0, 0));
+}
@@ -0,0 +1,130 @@
+#include "LightTree.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <random>
+
+using namespace IG;
+
+// Layout of a node in the serialized tree, see light_selector.art
+struct TreeNode {
+    Vector3f Min;
+    float Power;
+    Vector3f Max;
+    float ThetaO;
+    Vector3f Axis;
+    float ThetaE;
+    int32 Left;
+    int32 Right;
+    int32 ID;
+    uint32 Padding;
+};
+static_assert(sizeof(TreeNode) == 16 * sizeof(float), "Expected node to match the serialized layout");
+
+struct LightEntry {
+    uint32 Trail;
+    uint32 InTree;
+};
+
+static void check_tree(size_t finiteCount, size_t infiniteCount)
+{
+    std::mt19937 rnd(42);
+    std::uniform_real_distribution<float> pos(-100, 100);
+    std::uniform_real_distribution<float> extent(0, 5);
+    std::uniform_real_distribution<float> dir(-1, 1);
+    std::uniform_real_distribution<float> angle(0, Pi);
+
+    // Finite and infinite lights are interleaved in the id space
+    const size_t lightCount = finiteCount + infiniteCount;
+    std::vector<bool> isFinite(lightCount, false);
+    for (size_t i = 0; i < finiteCount; ++i)
+        isFinite[(i * 7) % lightCount] = true; // 7 is coprime to all tested counts
+
+    LightTree tree;
+    for (size_t id = 0; id < lightCount; ++id) {
+        if (isFinite[id]) {
+            const Vector3f min = Vector3f(pos(rnd), pos(rnd), pos(rnd));
+            const Vector3f max = min + Vector3f(extent(rnd), extent(rnd), extent(rnd));
+            tree.addFinite((uint32)id, BoundingBox(min, max), Vector3f(dir(rnd), dir(rnd), dir(rnd)) + Vector3f(0, 0, 0.01f), angle(rnd), angle(rnd) / 2, 1 + extent(rnd));
+        } else {
+            tree.addInfinite((uint32)id, 1);
+        }
+    }
+
+    std::vector<uint8> data;
+    tree.build(data, lightCount);
+
+    REQUIRE(tree.nodeCount() == (finiteCount == 0 ? 0 : 2 * finiteCount - 1));
+    REQUIRE(tree.infiniteCount() == infiniteCount);
+    REQUIRE(data.size() == tree.nodeCount() * sizeof(TreeNode) + lightCount * sizeof(LightEntry) + infiniteCount * sizeof(uint32));
+
+    std::vector<TreeNode> nodes(tree.nodeCount());
+    std::vector<LightEntry> lights(lightCount);
+    std::memcpy(reinterpret_cast<uint8*>(nodes.data()), data.data(), nodes.size() * sizeof(TreeNode));
+    std::memcpy(lights.data(), data.data() + nodes.size() * sizeof(TreeNode), lights.size() * sizeof(LightEntry));
+
+    // The bounds of inner nodes contain the bounds of their children
+    constexpr float Eps = 1e-3f;
+    for (const auto& node : nodes) {
+        if (node.ID >= 0) {
+            CHECK(node.Left == -1);
+            CHECK(node.Right == -1);
+            continue;
+        }
+
+        REQUIRE(node.Left >= 0);
+        REQUIRE(node.Right >= 0);
+        REQUIRE((size_t)node.Left < nodes.size());
+        REQUIRE((size_t)node.Right < nodes.size());
+        for (const auto& child : { nodes[node.Left], nodes[node.Right] }) {
+            CHECK((node.Min.array() <= child.Min.array()).all());
+            CHECK((node.Max.array() >= child.Max.array()).all());
+            CHECK(node.ThetaE >= child.ThetaE);
+
+            const float thetaD = std::acos(std::clamp(node.Axis.dot(child.Axis), -1.0f, 1.0f));
+            CHECK(std::min(thetaD + child.ThetaO, Pi) <= node.ThetaO + Eps);
+        }
+        CHECK(std::abs(node.Power - (nodes[node.Left].Power + nodes[node.Right].Power)) <= Eps * node.Power);
+    }
+
+    // The trail of each light leads from the root to the leaf of the light
+    size_t maxDepth = 0;
+    for (size_t id = 0; id < lightCount; ++id) {
+        CHECK(lights[id].InTree == (isFinite[id] ? 1u : 0u));
+        if (!isFinite[id])
+            continue;
+
+        int32 node   = 0;
+        size_t depth = 0;
+        while (nodes[node].ID < 0) {
+            REQUIRE(depth < 32);
+            node = ((lights[id].Trail >> depth) & 1) == 0 ? nodes[node].Left : nodes[node].Right;
+            ++depth;
+        }
+
+        CHECK(nodes[node].ID == (int32)id);
+        maxDepth = std::max(maxDepth, depth);
+    }
+    CHECK(maxDepth <= 32);
+}
+
+TEST_CASE("Check light tree over a single light", "[LightTree]")
+{
+    check_tree(1, 0);
+}
+
+TEST_CASE("Check light tree over many lights", "[LightTree]")
+{
+    check_tree(2, 0);
+    check_tree(3, 0);
+    check_tree(100, 0);
+    check_tree(1000, 0);
+    check_tree(4096, 0);
+}
+
+TEST_CASE("Check light tree with infinite lights", "[LightTree]")
+{
+    check_tree(100, 6);
+    check_tree(0, 3);
+}
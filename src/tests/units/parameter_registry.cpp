@@ -0,0 +1,61 @@
+#include "ParameterSet.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+
+using namespace IG;
+
+static inline int slotAsInt(const ParameterSet& set, size_t slot)
+{
+    int value;
+    std::memcpy(&value, &set.Block[slot * ParameterSet::SlotSize], sizeof(value));
+    return value;
+}
+
+TEST_CASE("Check if parameters are resolved to stable slots", "[ParameterSet]")
+{
+    ParameterSet set;
+    set.setInt("__spi", 4); // Already set before resolving
+
+    const size_t spi = set.resolveInt("__spi", 1);
+    const size_t eye = set.resolveVector("__camera_eye", Vector3f(1, 2, 3));
+
+    CHECK(spi != eye);
+    CHECK(set.resolveInt("__spi", 1) == spi);
+    CHECK(set.Block.size() == 2 * ParameterSet::SlotSize);
+
+    CHECK(slotAsInt(set, spi) == 4);
+    CHECK(set.Block[eye * ParameterSet::SlotSize + 2] == 3.0f);
+
+    set.setInt("__spi", 8);
+    set.setVector("__camera_eye", Vector3f(4, 5, 6));
+    CHECK(slotAsInt(set, spi) == 8);
+    CHECK(set.Block[eye * ParameterSet::SlotSize + 0] == 4.0f);
+
+    set.setFloat("__unresolved", 1.0f); // Only available by name
+    CHECK(set.Slots.size() == 2);
+}
+
+// Compares the former lookup by name, as done by the driver, with the access by slot
+TEST_CASE("Parameter access by name and by slot", "[ParameterSet][!benchmark]")
+{
+    ParameterSet set;
+    for (int i = 0; i < 32; ++i)
+        set.setInt("__param_" + std::to_string(i), i);
+
+    set.setInt("__spi", 8);
+    const size_t slot = set.resolveInt("__spi", 1);
+
+    const char* name = "__spi";
+    BENCHMARK("By name")
+    {
+        return set.IntParameters.count(name) > 0 ? set.IntParameters.at(name) : 1;
+    };
+
+    BENCHMARK("By slot")
+    {
+        return slotAsInt(set, slot);
+    };
+}
@@ -0,0 +1,162 @@
+#include "ErrorEstimator.h"
+#include "RenderBudget.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+
+using namespace IG;
+
+TEST_CASE("Iteration limit exhausts the budget", "[RenderBudget]")
+{
+    RenderBudget budget(4, 0, 0);
+    CHECK(budget.isBounded());
+    CHECK_FALSE(budget.isExhausted());
+    CHECK(budget.estimateRemainingIterations() == 4);
+
+    for (int i = 0; i < 3; ++i)
+        budget.addIteration(10);
+    CHECK_FALSE(budget.isExhausted());
+    CHECK(budget.estimateRemainingIterations() == 1);
+
+    budget.addIteration(10);
+    CHECK(budget.isExhausted());
+    CHECK(budget.estimateRemainingIterations() == 0);
+}
+
+TEST_CASE("Time budget is not exceeded by the next iteration", "[RenderBudget]")
+{
+    RenderBudget budget(0, 100, 0);
+    CHECK(budget.isBounded());
+
+    budget.addIteration(20);
+    CHECK_FALSE(budget.isExhausted());
+    CHECK(budget.estimateRemainingIterations() == 4);
+
+    for (int i = 0; i < 3; ++i)
+        budget.addIteration(20);
+    CHECK_FALSE(budget.isExhausted()); // 80ms spent, the next iteration fits exactly
+
+    budget.addIteration(20);
+    CHECK(budget.isExhausted());
+}
+
+TEST_CASE("First iteration exceeding the time budget", "[RenderBudget]")
+{
+    RenderBudget budget(0, 100, 0);
+    budget.addIteration(250);
+    CHECK(budget.isExhausted());
+    CHECK(budget.estimateRemainingIterations() == 0);
+}
+
+TEST_CASE("Target error alone is not bounded", "[RenderBudget]")
+{
+    RenderBudget budget(0, 0, 0.01f);
+    CHECK(budget.hasTargetError());
+    CHECK_FALSE(budget.isBounded());
+
+    // Unknown error never exhausts the budget
+    budget.addIteration(10);
+    budget.setError(-1);
+    CHECK_FALSE(budget.isExhausted());
+    CHECK(budget.estimateRemainingIterations() == 0);
+
+    // The error is expected to halve with four times the iterations
+    budget.setError(0.02f);
+    CHECK_FALSE(budget.isExhausted());
+    CHECK(budget.estimateRemainingIterations() == 3);
+
+    budget.setError(0.01f);
+    CHECK(budget.isExhausted());
+}
+
+TEST_CASE("Remaining iterations are limited by the tightest limit", "[RenderBudget]")
+{
+    RenderBudget budget(100, 50, 0.01f);
+    budget.addIteration(10);
+    budget.setError(0.1f);
+    CHECK(budget.estimateRemainingIterations() == 4);
+}
+
+// Film with a single channel value per pixel, the same in all three channels
+static void accumulate(std::vector<float>& film, std::mt19937& rng, bool noisy)
+{
+    std::uniform_real_distribution<float> dist(0, 2);
+    for (size_t i = 0; i < film.size() / 3; ++i) {
+        const float value = noisy ? dist(rng) : 1.0f;
+        for (size_t c = 0; c < 3; ++c)
+            film[3 * i + c] += value;
+    }
+}
+
+TEST_CASE("Snapshots at power of two iterations are used as reference", "[ErrorEstimator]")
+{
+    constexpr size_t PixelCount = 64;
+
+    std::mt19937 rng(42);
+    std::vector<float> film(PixelCount * 3, 0.0f);
+    ErrorEstimator estimator;
+
+    // Given the iteration, the iteration of the expected reference snapshot
+    const auto expectedReference = [](size_t iteration) -> size_t {
+        size_t reference = 0;
+        for (size_t snapshot = ErrorEstimator::MinIterations; 2 * snapshot <= iteration; snapshot *= 2)
+            reference = snapshot;
+        return reference;
+    };
+
+    for (size_t iter = 1; iter <= 40; ++iter) {
+        accumulate(film, rng, true);
+        const float error = estimator.update(film.data(), PixelCount, iter);
+
+        // Only the last two snapshots are kept, which is sufficient as the reference covers at least a quarter of the iterations
+        CHECK(estimator.referenceIteration() == expectedReference(iter));
+        if (estimator.referenceIteration() == 0)
+            CHECK(error < 0);
+        else
+            CHECK(error > 0);
+    }
+}
+
+TEST_CASE("Decreasing iteration count resets the estimator", "[ErrorEstimator]")
+{
+    constexpr size_t PixelCount = 16;
+
+    std::mt19937 rng(42);
+    std::vector<float> film(PixelCount * 3, 0.0f);
+    ErrorEstimator estimator;
+
+    for (size_t iter = 1; iter <= 16; ++iter) {
+        accumulate(film, rng, true);
+        estimator.update(film.data(), PixelCount, iter);
+    }
+    REQUIRE(estimator.referenceIteration() == 8);
+
+    // Restart rendering from scratch
+    std::fill(film.begin(), film.end(), 0.0f);
+    accumulate(film, rng, true);
+    CHECK(estimator.update(film.data(), PixelCount, 1) < 0);
+    CHECK(estimator.referenceIteration() == 0);
+
+    // A different film size resets as well
+    std::vector<float> other(2 * PixelCount * 3, 0.0f);
+    accumulate(other, rng, true);
+    CHECK(estimator.update(other.data(), 2 * PixelCount, 32) < 0);
+}
+
+TEST_CASE("Noise free images have no error", "[ErrorEstimator]")
+{
+    constexpr size_t PixelCount = 16;
+
+    std::mt19937 rng(42);
+    std::vector<float> film(PixelCount * 3, 0.0f);
+    ErrorEstimator estimator;
+
+    float error = -1;
+    for (size_t iter = 1; iter <= 8; ++iter) {
+        accumulate(film, rng, false);
+        error = estimator.update(film.data(), PixelCount, iter);
+    }
+    CHECK(error >= 0);
+    CHECK(error < 1e-5f);
+}
@@ -0,0 +1,166 @@
+#include "loader/LoaderContext.h"
+#include "loader/LoaderLight.h"
+#include "loader/SceneCache.h"
+#include "table/SceneDatabase.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+using namespace IG;
+static SceneBVH make_bvh()
+{
+    SceneBVH bvh;
+    bvh.Nodes  = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    bvh.Leaves = { 42, 43 };
+    return bvh;
+}
+
+TEST_CASE("Check if stored scene bvhs are found again", "[SceneCache]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "ignis_test_scene_cache";
+    std::filesystem::remove_all(root);
+
+    const SceneBVH bvh = make_bvh();
+    {
+        SceneCache cache(root, Target::GENERIC);
+        REQUIRE(cache.isEnabled());
+
+        SceneBVH loaded;
+        CHECK_FALSE(cache.loadSceneBVH(1, loaded));
+        cache.storeSceneBVH(1, bvh);
+        REQUIRE(cache.loadSceneBVH(1, loaded));
+        CHECK(loaded.Nodes == bvh.Nodes);
+        CHECK(loaded.Leaves == bvh.Leaves);
+
+        CHECK_FALSE(cache.loadSceneBVH(2, loaded));
+    }
+
+    {
+        // Same target in a new session
+        SceneCache cache(root, Target::GENERIC);
+        SceneBVH loaded;
+        CHECK(cache.loadSceneBVH(1, loaded));
+
+        // Different targets never share entries
+        SceneCache cache2(root, Target::AVX2);
+        CHECK(cache.seed() != cache2.seed());
+        CHECK_FALSE(cache2.loadSceneBVH(1, loaded));
+    }
+
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("Check if truncated entries are ignored", "[SceneCache]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "ignis_test_scene_cache_truncated";
+    std::filesystem::remove_all(root);
+
+    SceneCache cache(root, Target::GENERIC);
+    cache.storeSceneBVH(1, make_bvh());
+
+    for (const auto& entry : std::filesystem::directory_iterator(cache.directory()))
+        std::filesystem::resize_file(entry.path(), std::filesystem::file_size(entry.path()) - 1);
+
+    SceneBVH loaded;
+    CHECK_FALSE(cache.loadSceneBVH(1, loaded));
+
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("Check if shape tables are mapped from the cache", "[SceneCache]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "ignis_test_scene_cache_shapes";
+    std::filesystem::remove_all(root);
+
+    SceneCache cache(root, Target::GENERIC);
+
+    const std::vector<uint8> shapeData = { 1, 2, 3, 4, 5 };
+    {
+        LoaderContext ctx;
+        ctx.Environment.Shapes.push_back(Shape{ 3, 3, 0, 1, BoundingBox::Empty(), 0.5f });
+        ctx.Environment.ShapeIDs["shape"]           = 0;
+        ctx.Environment.ShapeIDs["instance"]        = 0;
+        ctx.Environment.ShapeTransforms["instance"] = Transformf(Eigen::Translation3f(1, 2, 3));
+
+        SceneDatabase database;
+        database.ShapeTable.addLookup(0, 0, 16).insert(database.ShapeTable.data().end(), shapeData.begin(), shapeData.end());
+        database.BVHTable.addLookup(0, 0, 16).push_back(42);
+        cache.storeShapes(1, ctx, database);
+    }
+
+    LoaderContext ctx;
+    SceneDatabase database;
+    REQUIRE(cache.loadShapes(1, ctx, database));
+
+    REQUIRE(ctx.Environment.Shapes.size() == 1);
+    CHECK(ctx.Environment.ShapeIDs.at("shape") == 0);
+    CHECK(ctx.Environment.ShapeIDs.at("instance") == 0);
+    CHECK(ctx.Environment.ShapeTransforms.count("shape") == 0);
+    REQUIRE(ctx.Environment.ShapeTransforms.count("instance") == 1);
+    CHECK(ctx.Environment.ShapeTransforms.at("instance").translation().isApprox(Vector3f(1, 2, 3)));
+    CHECK(ctx.Environment.Shapes[0].FaceCount == 1);
+    CHECK(ctx.Environment.Shapes[0].Area == 0.5f);
+
+    REQUIRE(database.ShapeTable.isExternal());
+    REQUIRE(database.ShapeTable.entryCount() == 1);
+    REQUIRE(database.ShapeTable.dataSize() == shapeData.size());
+    CHECK(std::equal(shapeData.begin(), shapeData.end(), database.ShapeTable.dataPtr()));
+    CHECK(reinterpret_cast<uintptr_t>(database.ShapeTable.dataPtr()) % 64 == 0);
+    REQUIRE(database.BVHTable.dataSize() == 1);
+    CHECK(database.BVHTable.dataPtr()[0] == 42);
+
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("Check if invalid shape entries leave the context untouched", "[SceneCache]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "ignis_test_scene_cache_shapes_invalid";
+    std::filesystem::remove_all(root);
+
+    SceneCache cache(root, Target::GENERIC);
+    {
+        LoaderContext ctx;
+        ctx.Environment.Shapes.push_back(Shape{ 3, 3, 0, 1, BoundingBox::Empty(), 0.5f });
+        ctx.Environment.ShapeIDs["shape"]        = 0;
+        ctx.Environment.ShapeTransforms["shape"] = Transformf(Eigen::Translation3f(1, 2, 3));
+
+        SceneDatabase database;
+        database.ShapeTable.addLookup(0, 0, 16).push_back(1);
+        database.BVHTable.addLookup(0, 0, 16).push_back(42);
+        cache.storeShapes(1, ctx, database);
+    }
+
+    // Let the bvh table, which is mapped last, point past the end of the entry
+    for (const auto& entry : std::filesystem::directory_iterator(cache.directory())) {
+        std::vector<char> data(std::filesystem::file_size(entry.path()));
+        std::fstream file(entry.path(), std::ios::in | std::ios::out | std::ios::binary);
+        file.read(data.data(), data.size());
+
+        const uint64 header[2] = { 1, 1 }; // Entry count and data size
+        const char* begin      = reinterpret_cast<const char*>(header);
+        const auto it          = std::find_end(data.begin(), data.end(), begin, begin + sizeof(header));
+        REQUIRE(it != data.end());
+
+        const uint64 size = uint64(1) << 40;
+        file.seekp(std::distance(data.begin(), it) + sizeof(uint64));
+        file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    }
+
+    LoaderContext ctx;
+    ctx.Environment.ShapeIDs["existing"] = 7;
+    SceneDatabase database;
+    CHECK_FALSE(cache.loadShapes(1, ctx, database));
+
+    CHECK(ctx.Environment.Shapes.empty());
+    CHECK(ctx.Environment.PlaneShapes.empty());
+    CHECK(ctx.Environment.ShapeTransforms.empty());
+    REQUIRE(ctx.Environment.ShapeIDs.size() == 1);
+    CHECK(ctx.Environment.ShapeIDs.at("existing") == 7);
+    CHECK_FALSE(database.ShapeTable.isExternal());
+    CHECK(database.ShapeTable.entryCount() == 0);
+    CHECK(database.BVHTable.entryCount() == 0);
+
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,52 @@
+#include "shader/ShaderCache.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace IG;
+TEST_CASE("Check if stored shaders are found again", "[ShaderCache]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "ignis_test_shader_cache";
+    std::filesystem::remove_all(root);
+
+    const std::string src = "fn main() -> () {}";
+    {
+        ShaderCache cache(root, Target::GENERIC, 0, 1);
+        REQUIRE(cache.isEnabled());
+
+        const uint64 key = cache.computeKey(src);
+        CHECK_FALSE(cache.has(key, src));
+        cache.store(key, src);
+        CHECK(cache.has(key, src));
+
+        CHECK(cache.foundMarkerCount() == 1);
+        CHECK(cache.missingMarkerCount() == 1);
+    }
+
+    {
+        // Same target and version in a new session
+        ShaderCache cache(root, Target::GENERIC, 0, 1);
+        CHECK(cache.has(cache.computeKey(src), src));
+    }
+
+    {
+        // Different target or driver version never share entries
+        ShaderCache cache1(root, Target::AVX2, 0, 1);
+        ShaderCache cache2(root, Target::GENERIC, 0, 2);
+        CHECK_FALSE(cache1.has(cache1.computeKey(src), src));
+        CHECK_FALSE(cache2.has(cache2.computeKey(src), src));
+    }
+
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("Check if a disabled cache never finds a marker", "[ShaderCache]")
+{
+    ShaderCache cache({}, Target::GENERIC, 0, 1);
+    REQUIRE_FALSE(cache.isEnabled());
+
+    const std::string src = "fn main() -> () {}";
+    const uint64 key      = cache.computeKey(src);
+    cache.store(key, src);
+    CHECK_FALSE(cache.has(key, src));
+    CHECK(cache.missingMarkerCount() == 0);
+}
@@ -0,0 +1,101 @@
+#include "loader/LoaderShape.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace IG;
+
+static const char* SceneString = R"({
+    "shapes": [
+        {"name":"a", "type":"cube", "width":2, "transform":{"translate":[1,0,0]}},
+        {"name":"b", "type":"cube", "width":2, "transform":{"translate":[0,2,0]}},
+        {"name":"c", "type":"cube", "width":4}
+    ],
+    "entities": [
+        {"name":"single", "shape":"a", "transform":{"scale":2}},
+        {"name":"single", "shape":"b"},
+        {"name":"tree_1", "shape":"a"},
+        {"name":"tree", "shape":"c", "transform":{"translate":[0,0,1]}, "instances":[{"translate":[1,0,0]}, {"scale":3}, {"rotate":[0,0,90]}]}
+    ]
+})";
+
+static Parser::Scene load_scene()
+{
+    bool ok             = false;
+    Parser::Scene scene = Parser::SceneParser().loadFromString(SceneString, ok);
+    REQUIRE(ok);
+    return scene;
+}
+
+static Transformf make_transform(const Vector3f& translation, float scale = 1)
+{
+    Transformf transform = Transformf::Identity();
+    transform.translate(translation);
+    transform.scale(scale);
+    return transform;
+}
+
+TEST_CASE("Check if shapes differing only in their transform share a definition", "[Shape]")
+{
+    const Parser::Scene scene = load_scene();
+
+    const auto groups = LoaderShape::group(scene);
+    REQUIRE(groups.Names.size() == 3);
+    CHECK(groups.Representatives.size() == 2);
+
+    LoaderEnvironment env;
+    LoaderShape::assign(groups, scene, env);
+
+    REQUIRE(env.ShapeIDs.count("a") == 1);
+    REQUIRE(env.ShapeIDs.count("b") == 1);
+    REQUIRE(env.ShapeIDs.count("c") == 1);
+    CHECK(env.ShapeIDs["a"] == env.ShapeIDs["b"]);
+    CHECK(env.ShapeIDs["a"] != env.ShapeIDs["c"]);
+
+    // The shared mesh is not transformed, so the entities have to apply the transforms of the shapes
+    CHECK_FALSE(groups.BakeTransform[env.ShapeIDs["a"]]);
+    CHECK(groups.BakeTransform[env.ShapeIDs["c"]]);
+    REQUIRE(env.ShapeTransforms.count("a") == 1);
+    REQUIRE(env.ShapeTransforms.count("b") == 1);
+    CHECK(env.ShapeTransforms.count("c") == 0);
+    CHECK(env.ShapeTransforms["a"].matrix().isApprox(make_transform(Vector3f(1, 0, 0)).matrix()));
+    CHECK(env.ShapeTransforms["b"].matrix().isApprox(make_transform(Vector3f(0, 2, 0)).matrix()));
+
+    // The transform of the shape is applied before the transform of the entity
+    const Transformf entityTransform = scene.entity("single")->property("transform").getTransform();
+    const Transformf composed        = env.computeEntityTransform("a", entityTransform);
+    CHECK(composed.matrix().isApprox(make_transform(Vector3f(2, 0, 0), 2).matrix()));
+    CHECK(env.computeEntityTransform("c", entityTransform).matrix().isApprox(entityTransform.matrix()));
+}
+
+TEST_CASE("Check if entity instances are expanded", "[Shape]")
+{
+    const Parser::Scene scene = load_scene();
+
+    CHECK(scene.entity("tree") == nullptr);
+    REQUIRE(scene.entity("tree_0") != nullptr);
+    REQUIRE(scene.entity("tree_2") != nullptr);
+    CHECK(scene.entity("tree_3") == nullptr);
+
+    const Transformf transform = make_transform(Vector3f(0, 0, 1));
+
+    CHECK(scene.entity("tree_0")->property("shape").getString() == "c");
+    CHECK(scene.entity("tree_0")->property("transform").getTransform().matrix().isApprox((make_transform(Vector3f(1, 0, 0)) * transform).matrix()));
+
+    Transformf rotation = Transformf::Identity();
+    rotation.rotate(Eigen::AngleAxisf(Deg2Rad * 90, Vector3f::UnitZ()));
+    CHECK(scene.entity("tree_2")->property("shape").getString() == "c");
+    CHECK(scene.entity("tree_2")->property("transform").getTransform().matrix().isApprox((rotation * transform).matrix()));
+}
+
+TEST_CASE("Check if entities with a name already in use are ignored", "[Shape]")
+{
+    const Parser::Scene scene = load_scene();
+
+    REQUIRE(scene.entity("single") != nullptr);
+    CHECK(scene.entity("single")->property("shape").getString() == "a");
+
+    // The expanded instance does not replace the existing entity
+    REQUIRE(scene.entity("tree_1") != nullptr);
+    CHECK(scene.entity("tree_1")->property("shape").getString() == "a");
+    CHECK(scene.entity("tree_1")->property("transform").getTransform().matrix().isIdentity());
+}
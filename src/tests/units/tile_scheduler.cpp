@@ -0,0 +1,101 @@
+#include "TileScheduler.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+
+using namespace IG;
+
+static std::vector<int> coverage(TileScheduler& scheduler, int32 width, int32 height)
+{
+    std::vector<int> pixels((size_t)width * height, 0);
+
+    TileRegion region;
+    uint32 id;
+    while (scheduler.acquire(region, id)) {
+        for (int32 y = region.YMin; y < region.YMax; ++y) {
+            for (int32 x = region.XMin; x < region.XMax; ++x)
+                pixels[(size_t)y * width + x]++;
+        }
+    }
+    return pixels;
+}
+
+static bool coveredOnce(const std::vector<int>& pixels)
+{
+    return std::all_of(pixels.begin(), pixels.end(), [](int count) { return count == 1; });
+}
+
+TEST_CASE("Tile size depends on film size and thread count", "[TileScheduler]")
+{
+    CHECK(TileScheduler::computeTileSize(1920, 1080, 16, 8) == 16);
+    CHECK(TileScheduler::computeTileSize(256, 256, 32, 1) == 32);
+    CHECK(TileScheduler::computeTileSize(256, 256, 32, 128) == 8);
+    CHECK(TileScheduler::computeTileSize(64, 64, 16, 4) == 8);
+    CHECK(TileScheduler::computeTileSize(4, 4, 16, 1) == TileScheduler::MinTileSize);
+}
+
+TEST_CASE("Tiles cover the whole film exactly once", "[TileScheduler]")
+{
+    TileScheduler scheduler;
+
+    const size_t count = scheduler.prepare(100, 37, 16, 2);
+    CHECK(count == scheduler.tileCount());
+    CHECK(coveredOnce(coverage(scheduler, 100, 37)));
+
+    TileRegion region;
+    uint32 id;
+    CHECK_FALSE(scheduler.acquire(region, id));
+}
+
+TEST_CASE("Expensive tiles are handed out first and split", "[TileScheduler]")
+{
+    constexpr int32 Width  = 128;
+    constexpr int32 Height = 128;
+
+    TileScheduler scheduler;
+    scheduler.prepare(Width, Height, 32, 1);
+    REQUIRE(scheduler.tileSize() == 32);
+
+    // The tile containing the center is a lot more expensive than all others
+    TileRegion region;
+    uint32 id;
+    while (scheduler.acquire(region, id)) {
+        const bool expensive = region.XMin <= 64 && 64 < region.XMax && region.YMin <= 64 && 64 < region.YMax;
+        scheduler.release(id, expensive ? 1000000 : 1000);
+    }
+
+    const size_t count = scheduler.prepare(Width, Height, 32, 1);
+    CHECK(count > 16); // The expensive tile got split
+
+    const TileRegion& first = scheduler.tile(0);
+    CHECK(first.width() < 32);
+    CHECK(first.XMin >= 64);
+    CHECK(first.YMin >= 64);
+    CHECK(first.XMax <= 96);
+    CHECK(first.YMax <= 96);
+
+    for (size_t i = 1; i < count; ++i)
+        CHECK(scheduler.estimateCost(scheduler.tile(i - 1)) >= scheduler.estimateCost(scheduler.tile(i)));
+
+    CHECK(coveredOnce(coverage(scheduler, Width, Height)));
+}
+
+TEST_CASE("Changing the film size discards the costs", "[TileScheduler]")
+{
+    TileScheduler scheduler;
+    scheduler.prepare(64, 64, 16, 1);
+
+    TileRegion region;
+    uint32 id;
+    while (scheduler.acquire(region, id))
+        scheduler.release(id, 1000);
+
+    scheduler.prepare(64, 64, 16, 1);
+    CHECK(scheduler.estimateCost(TileRegion{ 0, 0, 16, 16 }) > 0);
+
+    scheduler.prepare(80, 64, 16, 1);
+    CHECK(scheduler.estimateCost(TileRegion{ 0, 0, 16, 16 }) < 0);
+    CHECK(scheduler.tile(0).XMin == 0);
+    CHECK(scheduler.tile(0).YMin == 0);
+}